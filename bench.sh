@@ -0,0 +1,129 @@
+#!/bin/sh
+# bench.sh - Benchmark de tiempo de compilación del compilador FIS-25
+#
+# Genera el corpus sintético (src/gen_corpus) en varios tamaños, compila
+# cada programa con --stats-json y reporta tiempo y memoria por fase.
+# Para cada fase estima el exponente de crecimiento entre los dos tamaños
+# más grandes: ~1 es lineal, ~2 es cuadrático. Las fases que crecen más
+# rápido que n^1.5 se marcan con "<< superlineal".
+#
+# Uso: ./bench.sh [tamaños...]        (default: 1000 10000 100000)
+#
+# Variables de entorno:
+#   COMPILER   compilador a medir       (default: ./src/compiler)
+#   GEN        generador del corpus      (default: ./src/gen_corpus)
+#   SHAPES     formas del corpus         (default: vars expr nest arrays blocks funcs mixed)
+#   OUT        directorio de resultados  (default: bench_out)
+#   TIMEOUT    segundos por compilación  (default: 300)
+
+COMPILER=${COMPILER:-./src/compiler}
+GEN=${GEN:-./src/gen_corpus}
+SHAPES=${SHAPES:-"vars expr nest arrays blocks funcs mixed"}
+OUT=${OUT:-bench_out}
+TIMEOUT=${TIMEOUT:-300}
+SIZES=${*:-"1000 10000 100000"}
+
+for tool in "$COMPILER" "$GEN"; do
+    if [ ! -x "$tool" ]; then
+        echo "Error: no se encontró '$tool' (ver instrucciones_compilado.txt)" >&2
+        exit 1
+    fi
+done
+
+RUN=""
+command -v timeout >/dev/null 2>&1 && RUN="timeout $TIMEOUT"
+
+mkdir -p "$OUT"
+CSV="$OUT/resultados.csv"
+echo "forma,sentencias,fase,real_ms,cpu_ms,rss_kb" > "$CSV"
+
+for shape in $SHAPES; do
+    for n in $SIZES; do
+        base="$OUT/${shape}_$n"
+        "$GEN" "$shape" "$n" > "$base.fis" || exit 1
+        rm -f "$base.json"
+        printf "Compilando %-7s %8s sentencias... " "$shape" "$n"
+
+        # La salida del compilador (progreso y errores) queda en .log
+        if $RUN "$COMPILER" "$base.fis" -o "$base.fis25" --stats-json "$base.json" \
+                > "$base.log" 2>&1 && [ -f "$base.json" ]; then
+            awk -v shape="$shape" -v n="$n" '
+                function field(key,   pos) {
+                    if (!match($0, "\"" key "\": [0-9.]+")) return 0
+                    pos = index(substr($0, RSTART, RLENGTH), ":")
+                    return substr($0, RSTART + pos + 1, RLENGTH - pos - 1)
+                }
+                /"name":/ {
+                    split($0, parts, "\"")
+                    printf "%s,%s,%s,%s,%s,%s\n", shape, n, parts[4],
+                           field("wall_ms"), field("cpu_ms"), field("peak_rss_kb")
+                }
+                /"total":/ {
+                    printf "%s,%s,total,%s,%s,%s\n", shape, n,
+                           field("wall_ms"), field("cpu_ms"), field("peak_rss_kb")
+                }' "$base.json" >> "$CSV"
+            grep '^'"$shape,$n,total," "$CSV" | awk -F, '{ printf "%.1f ms, %d KB\n", $4, $6 }'
+        else
+            echo "falló o excedió ${TIMEOUT}s (ver $base.log)"
+            echo "$shape,$n,total,,," >> "$CSV"
+        fi
+    done
+done
+
+# Reporte: una tabla por forma con el tiempo real de cada fase por tamaño
+awk -F, -v sizes="$SIZES" '
+    # Rellena a "width" columnas sin contar los bytes de continuación UTF-8
+    function pad(text, width,   copy) {
+        copy = text
+        return sprintf("%-" (width + gsub(/[\200-\277]/, "", copy)) "s", text)
+    }
+    NR == 1 { next }
+    {
+        key = $1 SUBSEP $3
+        if (!(key in seen)) {
+            seen[key] = 1
+            phases[$1, ++phaseCount[$1]] = $3
+        }
+        if (!($1 in shapeSeen)) { shapeSeen[$1] = 1; shapes[++shapeCount] = $1 }
+        ms[$1, $3, $2] = $4
+        rss[$1, $2] = ($3 == "total") ? $6 : rss[$1, $2]
+    }
+    END {
+        sizeCount = split(sizes, size, " ")
+        for (s = 1; s <= shapeCount; s++) {
+            shape = shapes[s]
+            printf "\n== %s ==\n", shape
+            printf "  %-24s", "fase (ms)"
+            for (i = 1; i <= sizeCount; i++) printf " %11s", size[i]
+            printf " %9s\n", "exponente"
+            for (p = 1; p <= phaseCount[shape]; p++) {
+                phase = phases[shape, p]
+                printf "  %s", pad(phase, 24)
+                for (i = 1; i <= sizeCount; i++) {
+                    v = ms[shape, phase, size[i]]
+                    if (v == "") printf " %11s", "-"
+                    else printf " %11.2f", v
+                }
+                # Exponente entre los dos tamaños mayores con tiempo medible
+                growth = ""
+                for (i = sizeCount; i > 1; i--) {
+                    t1 = ms[shape, phase, size[i - 1]]; t2 = ms[shape, phase, size[i]]
+                    if (t1 != "" && t2 != "" && t1 >= 0.5 && size[i] > size[i - 1]) {
+                        growth = log(t2 / t1) / log(size[i] / size[i - 1])
+                        break
+                    }
+                }
+                if (growth == "") printf " %9s\n", "-"
+                else printf " %9.2f%s\n", growth, (growth >= 1.5 && t2 >= 10) ? "  << superlineal" : ""
+            }
+            printf "  %-24s", "pico RSS (KB)"
+            for (i = 1; i <= sizeCount; i++) {
+                v = rss[shape, size[i]]
+                printf " %11s", v == "" ? "-" : v
+            }
+            printf "\n"
+        }
+    }' "$CSV"
+
+echo
+echo "Resultados en $CSV"
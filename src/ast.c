@@ -7,37 +7,185 @@
 // Variable global para la raíz del AST
 //ASTNode* root = NULL;
 
+/* ============================================================
+   ARENA DE MEMORIA
+   ============================================================ */
+
+// Los nodos y sus cadenas se toman de bloques grandes que se liberan
+// todos juntos al final (freeASTArena). freeAST no devuelve memoria al
+// sistema: deja los nodos en una lista libre para reutilizarlos.
+#define ARENA_BLOCK_SIZE (256 * 1024)
+
+typedef struct ArenaBlock {
+    struct ArenaBlock* prev;
+    size_t used;
+    size_t size;
+    char data[];
+} ArenaBlock;
+
+static ArenaBlock* arena = NULL;
+static ASTNode* freeNodes = NULL;   // Enlazados por el campo next
+
+static void* arenaAlloc(size_t size) {
+    size = (size + 7) & ~(size_t)7;
+    if (!arena || arena->used + size > arena->size) {
+        size_t blockSize = size > ARENA_BLOCK_SIZE ? size : ARENA_BLOCK_SIZE;
+        ArenaBlock* block = malloc(sizeof(ArenaBlock) + blockSize);
+        if (!block) {
+            fprintf(stderr, "Error: No se pudo asignar memoria para nodo AST\n");
+            exit(1);
+        }
+        block->prev = arena;
+        block->used = 0;
+        block->size = blockSize;
+        arena = block;
+    }
+    void* ptr = arena->data + arena->used;
+    arena->used += size;
+    return ptr;
+}
+
+// Copia una cadena dentro de la arena
+char* astStrdup(const char* str) {
+    size_t length = strlen(str) + 1;
+    char* copy = arenaAlloc(length);
+    memcpy(copy, str, length);
+    return copy;
+}
+
+// Devuelve un nodo suelto (sus hijos no se tocan) a la lista libre
+void freeNode(ASTNode* node) {
+    if (!node) return;
+    node->next = freeNodes;
+    freeNodes = node;
+}
+
+/* ============================================================
+   IDENTIFICADORES INTERNADOS
+   ============================================================ */
+
+// Cada identificador se guarda una sola vez, precedido de un número
+// consecutivo. Dos nombres iguales son el mismo puntero, así que la tabla
+// de símbolos y el generador comparan punteros y usan el número como hash.
+typedef struct InternedName {
+    int id;
+    int isFunction;     // Ya se definió una función con este nombre
+    char text[];
+} InternedName;
+
+#define INTERN_INITIAL_CAPACITY 256
+
+static char** internTable = NULL;
+static int internCount = 0;
+static int internCapacity = 0;
+
+static unsigned int hashText(const char* str) {
+    unsigned int hash = 5381;
+    int c;
+    while ((c = *str++))
+        hash = ((hash << 5) + hash) + c;
+    return hash;
+}
+
+static void growInternTable() {
+    int capacity = internCapacity ? internCapacity * 2 : INTERN_INITIAL_CAPACITY;
+    char** table = calloc(capacity, sizeof(char*));
+    if (!table) {
+        fprintf(stderr, "Error: No se pudo ampliar la tabla de identificadores\n");
+        exit(1);
+    }
+    for (int i = 0; i < internCapacity; i++) {
+        if (!internTable[i]) continue;
+        unsigned int h = hashText(internTable[i]) & (capacity - 1);
+        while (table[h]) h = (h + 1) & (capacity - 1);
+        table[h] = internTable[i];
+    }
+    free(internTable);
+    internTable = table;
+    internCapacity = capacity;
+}
+
+// Copia única del identificador
+char* intern(const char* name) {
+    if ((internCount + 1) * 4 > internCapacity * 3) {
+        growInternTable();
+    }
+    
+    unsigned int h = hashText(name) & (internCapacity - 1);
+    while (internTable[h]) {
+        if (internTable[h] == name || strcmp(internTable[h], name) == 0) {
+            return internTable[h];
+        }
+        h = (h + 1) & (internCapacity - 1);
+    }
+    
+    size_t length = strlen(name) + 1;
+    InternedName* entry = arenaAlloc(sizeof(InternedName) + length);
+    entry->id = internCount++;
+    entry->isFunction = 0;
+    memcpy(entry->text, name, length);
+    internTable[h] = entry->text;
+    return entry->text;
+}
+
+// Número del identificador (0, 1, 2, ... en orden de aparición)
+int internId(const char* name) {
+    return ((const InternedName*)(name - offsetof(InternedName, text)))->id;
+}
+
+// El parser marca cada función al leer su nombre; desde ahí el lexer
+// devuelve FUNC_ID para ese identificador
+void markFunctionName(const char* name) {
+    ((InternedName*)(name - offsetof(InternedName, text)))->isFunction = 1;
+}
+
+int isFunctionName(const char* name) {
+    return ((const InternedName*)(name - offsetof(InternedName, text)))->isFunction;
+}
+
+// Bytes ocupados en la arena (nodos y cadenas)
+size_t astArenaBytes() {
+    size_t total = 0;
+    for (ArenaBlock* block = arena; block; block = block->prev) {
+        total += block->used;
+    }
+    return total;
+}
+
+// Libera de una vez todos los nodos y cadenas del AST
+void freeASTArena() {
+    while (arena) {
+        ArenaBlock* prev = arena->prev;
+        free(arena);
+        arena = prev;
+    }
+    freeNodes = NULL;
+    free(internTable);
+    internTable = NULL;
+    internCount = 0;
+    internCapacity = 0;
+}
+
 /* ============================================================
    FUNCIONES AUXILIARES
    ============================================================ */
 
 // Inicializa un nodo con valores por defecto
 static ASTNode* initNode() {
-    ASTNode* node = (ASTNode*)malloc(sizeof(ASTNode));
-    if (!node) {
-        fprintf(stderr, "Error: No se pudo asignar memoria para nodo AST\n");
-        exit(1);
+    ASTNode* node;
+    if (freeNodes) {
+        node = freeNodes;
+        freeNodes = node->next;
+    } else {
+        node = arenaAlloc(sizeof(ASTNode));
     }
     
     node->type = NODE_INT;
     node->varType = TYPE_VOID_T;  // ← CAMBIAR DE TYPE_INT_T A TYPE_VOID_T
-    node->intValue = 0;
-    node->floatValue = 0.0;
     node->idName = NULL;
-    node->stringValue = NULL;
-    node->left = NULL;
-    node->right = NULL;
-    node->extra = NULL;
-    node->cond = NULL;
-    node->body = NULL;
-    node->elseBody = NULL;
-    node->init = NULL;
-    node->increment = NULL;
-    node->params = NULL;
-    node->args = NULL;
+    node->stringValue = NULL;   // Limpia toda la unión
+    for (int k = 0; k < AST_MAX_KIDS; k++) node->kid[k] = NULL;
     node->next = NULL;
-    node->index = NULL;
-    node->arraySize = 0;
     
     return node;
 }
@@ -74,14 +222,14 @@ ASTNode* newString(char* str) {
     ASTNode* node = initNode();
     node->type = NODE_STRING;
     node->varType = TYPE_STRING_T;
-    node->stringValue = strdup(str);
+    node->stringValue = astStrdup(str);
     return node;
 }
 
 ASTNode* newId(char* name) {
     ASTNode* node = initNode();
     node->type = NODE_ID;
-    node->idName = strdup(name);
+    node->idName = intern(name);
     return node;
 }
 
@@ -92,8 +240,8 @@ ASTNode* newId(char* name) {
 ASTNode* newAssign(char* name, ASTNode* val) {
     ASTNode* node = initNode();
     node->type = NODE_ASSIGN;
-    node->idName = strdup(name);
-    node->left = val;
+    node->idName = intern(name);
+    AST_LEFT(node) = val;
     return node;
 }
 
@@ -101,8 +249,8 @@ ASTNode* newArrayDecl(VarType type, char* name, ASTNode* size) {
     ASTNode* node = initNode();
     node->type = NODE_ARRAY_DECL;
     node->varType = type;
-    node->idName = strdup(name);
-    node->left = size;
+    node->idName = intern(name);
+    AST_LEFT(node) = size;
     
     // Si el tamaño es un literal, guardarlo
     if (size && size->type == NODE_INT) {
@@ -115,15 +263,15 @@ ASTNode* newArrayDecl(VarType type, char* name, ASTNode* size) {
 ASTNode* newArrayAccess(char* name, ASTNode* index) {
     ASTNode* node = initNode();
     node->type = NODE_ARRAY_ACCESS;
-    node->idName = strdup(name);
-    node->index = index;
+    node->idName = intern(name);
+    AST_INDEX(node) = index;
     return node;
 }
 
 ASTNode* newArrayLength(char* name) {
     ASTNode* node = initNode();
     node->type = NODE_ARRAY_LENGTH;
-    node->idName = strdup(name);
+    node->idName = intern(name);
     node->varType = TYPE_INT_T;
     return node;
 }
@@ -135,9 +283,9 @@ ASTNode* newArrayLength(char* name) {
 ASTNode* newPixel(ASTNode* x, ASTNode* y, ASTNode* c) {
     ASTNode* node = initNode();
     node->type = NODE_PIXEL;
-    node->left = x;
-    node->right = y;
-    node->extra = c;
+    AST_LEFT(node) = x;
+    AST_RIGHT(node) = y;
+    AST_EXTRA(node) = c;
     return node;
 }
 
@@ -145,21 +293,21 @@ ASTNode* newKey(int keyNum, char* dest) {
     ASTNode* node = initNode();
     node->type = NODE_KEY;
     node->intValue = keyNum;
-    node->idName = strdup(dest);
+    node->idName = intern(dest);
     return node;
 }
 
 ASTNode* newInput(char* dest) {
     ASTNode* node = initNode();
     node->type = NODE_INPUT;
-    node->idName = strdup(dest);
+    node->idName = intern(dest);
     return node;
 }
 
 ASTNode* newPrint(ASTNode* expr) {
     ASTNode* node = initNode();
     node->type = NODE_PRINT;
-    node->left = expr;
+    AST_LEFT(node) = expr;
     return node;
 }
 
@@ -167,22 +315,61 @@ ASTNode* newPrint(ASTNode* expr) {
    SECUENCIAS Y BLOQUES
    ============================================================ */
 
+// Las secuencias son planas: agregar a una secuencia la extiende en su
+// lugar y una secuencia agregada a otra se desarma en sus sentencias, así
+// que los recorridos iteran en vez de bajar una vez por sentencia.
+#define SEQ_INITIAL_CAPACITY 4
+
+static ASTNode* newSeqNode() {
+    ASTNode* node = initNode();
+    node->type = NODE_SEQ;
+    node->stmts = arenaAlloc(sizeof(StmtList) + sizeof(ASTNode*) * SEQ_INITIAL_CAPACITY);
+    node->stmts->count = 0;
+    node->stmts->capacity = SEQ_INITIAL_CAPACITY;
+    return node;
+}
+
+// Agrega una sentencia (o todas las de otra secuencia) al final de seq
+void seqAppend(ASTNode* seq, ASTNode* stmt) {
+    if (!stmt) return;
+    if (stmt->type == NODE_SEQ) {
+        for (int i = 0; i < AST_STMT_COUNT(stmt); i++) {
+            seqAppend(seq, AST_STMT(stmt, i));
+        }
+        freeNode(stmt);
+        return;
+    }
+    
+    StmtList* list = seq->stmts;
+    if (list->count == list->capacity) {
+        // El arreglo anterior queda en la arena hasta freeASTArena
+        int capacity = list->capacity * 2;
+        StmtList* grown = arenaAlloc(sizeof(StmtList) + sizeof(ASTNode*) * capacity);
+        memcpy(grown, list, sizeof(StmtList) + sizeof(ASTNode*) * list->count);
+        grown->capacity = capacity;
+        seq->stmts = list = grown;
+    }
+    list->items[list->count++] = stmt;
+}
+
 ASTNode* newSeq(ASTNode* first, ASTNode* second) {
     // Si alguno es NULL, retornar el otro
     if (!first) return second;
     if (!second) return first;
     
-    ASTNode* node = initNode();
-    node->type = NODE_SEQ;
-    node->left = first;
-    node->right = second;
+    ASTNode* node = first;
+    if (first->type != NODE_SEQ) {
+        node = newSeqNode();
+        seqAppend(node, first);
+    }
+    seqAppend(node, second);
     return node;
 }
 
 ASTNode* newBlock(ASTNode* stmts) {
     ASTNode* node = initNode();
     node->type = NODE_BLOCK;
-    node->body = stmts;
+    AST_BODY(node) = stmts;
     return node;
 }
 
@@ -193,8 +380,8 @@ ASTNode* newBlock(ASTNode* stmts) {
 ASTNode* newBinOp(NodeType op, ASTNode* left, ASTNode* right) {
     ASTNode* node = initNode();
     node->type = op;
-    node->left = left;
-    node->right = right;
+    AST_LEFT(node) = left;
+    AST_RIGHT(node) = right;
     
     // Inferir tipo básico (se refinará en análisis semántico)
     switch (op) {
@@ -232,7 +419,7 @@ ASTNode* newBinOp(NodeType op, ASTNode* left, ASTNode* right) {
 ASTNode* newUnaryOp(NodeType op, ASTNode* operand) {
     ASTNode* node = initNode();
     node->type = op;
-    node->left = operand;
+    AST_LEFT(node) = operand;
     
     if (op == NODE_NOT) {
         node->varType = TYPE_BOOL_T;
@@ -248,35 +435,35 @@ ASTNode* newUnaryOp(NodeType op, ASTNode* operand) {
 ASTNode* newIf(ASTNode* cond, ASTNode* body) {
     ASTNode* node = initNode();
     node->type = NODE_IF;
-    node->cond = cond;
-    node->body = body;
+    AST_COND(node) = cond;
+    AST_BODY(node) = body;
     return node;
 }
 
 ASTNode* newIfElse(ASTNode* cond, ASTNode* body, ASTNode* elseBody) {
     ASTNode* node = initNode();
     node->type = NODE_IF_ELSE;
-    node->cond = cond;
-    node->body = body;
-    node->elseBody = elseBody;
+    AST_COND(node) = cond;
+    AST_BODY(node) = body;
+    AST_ELSE(node) = elseBody;
     return node;
 }
 
 ASTNode* newWhile(ASTNode* cond, ASTNode* body) {
     ASTNode* node = initNode();
     node->type = NODE_WHILE;
-    node->cond = cond;
-    node->body = body;
+    AST_COND(node) = cond;
+    AST_BODY(node) = body;
     return node;
 }
 
 ASTNode* newFor(ASTNode* init, ASTNode* cond, ASTNode* inc, ASTNode* body) {
     ASTNode* node = initNode();
     node->type = NODE_FOR;
-    node->init = init;
-    node->cond = cond;
-    node->increment = inc;
-    node->body = body;
+    AST_INIT(node) = init;
+    AST_COND(node) = cond;
+    AST_INCREMENT(node) = inc;
+    AST_BODY(node) = body;
     return node;
 }
 
@@ -288,27 +475,98 @@ ASTNode* newFunction(VarType retType, char* name, ASTNode* params, ASTNode* body
     ASTNode* node = initNode();
     node->type = NODE_FUNCTION;
     node->varType = retType;
-    node->idName = strdup(name);
-    node->params = params;
-    node->body = body;
+    node->idName = intern(name);
+    AST_PARAMS(node) = params;
+    AST_BODY(node) = body;
     return node;
 }
 
 ASTNode* newCall(char* name, ASTNode* args) {
     ASTNode* node = initNode();
     node->type = NODE_CALL;
-    node->idName = strdup(name);
-    node->args = args;
+    node->idName = intern(name);
+    AST_ARGS(node) = args;
     return node;
 }
 
 ASTNode* newReturn(ASTNode* expr) {
     ASTNode* node = initNode();
     node->type = NODE_RETURN;
-    node->left = expr;
+    AST_LEFT(node) = expr;
     return node;
 }
 
+// Agrega item al final de una lista enlazada por next (parámetros, argumentos)
+ASTNode* appendNext(ASTNode* list, ASTNode* item) {
+    if (!list) return item;
+    ASTNode* last = list;
+    while (last->next) last = last->next;
+    last->next = item;
+    return list;
+}
+
+// Nombres declarados dentro de una función (parámetros y variables)
+typedef struct {
+    char** names;
+    int count;
+    int capacity;
+} LocalNames;
+
+static int isLocalName(LocalNames* locals, const char* name) {
+    for (int i = 0; i < locals->count; i++) {
+        if (strcmp(locals->names[i], name) == 0) return 1;
+    }
+    return 0;
+}
+
+static void addLocalName(LocalNames* locals, char* name) {
+    if (isLocalName(locals, name)) return;
+    if (locals->count == locals->capacity) {
+        locals->capacity = locals->capacity ? locals->capacity * 2 : 16;
+        locals->names = realloc(locals->names, sizeof(char*) * locals->capacity);
+    }
+    locals->names[locals->count++] = name;
+}
+
+static void collectLocals(ASTNode* node, LocalNames* locals) {
+    if (!node) return;
+    if ((node->type == NODE_ASSIGN && node->varType != TYPE_VOID_T && !AST_INDEX(node)) ||
+        node->type == NODE_ARRAY_DECL) {
+        addLocalName(locals, node->idName);
+    }
+    for (int k = 0; k < AST_KID_COUNT(node); k++) collectLocals(AST_KIDS(node)[k], locals);
+    collectLocals(node->next, locals);
+}
+
+static void renameLocals(ASTNode* node, LocalNames* locals, const char* function) {
+    if (!node) return;
+    if (node->idName && node->type != NODE_CALL && node->type != NODE_FUNCTION &&
+        isLocalName(locals, node->idName)) {
+        char* name = malloc(strlen(function) + strlen(node->idName) + 3);
+        sprintf(name, "%s__%s", function, node->idName);
+        node->idName = intern(name);
+        free(name);
+    }
+    for (int k = 0; k < AST_KID_COUNT(node); k++) {
+        renameLocals(AST_KIDS(node)[k], locals, function);
+    }
+    renameLocals(node->next, locals, function);
+}
+
+// Los parámetros y variables locales de una función pasan a llamarse
+// funcion__nombre: cada función tiene celdas propias y fijas (no hay pila)
+void qualifyLocals(ASTNode* function) {
+    LocalNames locals = { NULL, 0, 0 };
+    for (ASTNode* p = AST_PARAMS(function); p; p = p->next) {
+        addLocalName(&locals, p->idName);
+    }
+    collectLocals(AST_BODY(function), &locals);
+
+    renameLocals(AST_PARAMS(function), &locals, function->idName);
+    renameLocals(AST_BODY(function), &locals, function->idName);
+    free(locals.names);
+}
+
 /* ============================================================
    UTILIDADES
    ============================================================ */
@@ -356,6 +614,34 @@ static const char* nodeTypeToString(NodeType type) {
     }
 }
 
+// Nombre de la ranura k para el tipo de nodo (ver KID_* en ast.h)
+static const char* kidLabel(NodeType type, int k) {
+    static const char* control[AST_MAX_KIDS] = { "cond", "body", "else", "init" };
+    static const char* forLoop[AST_MAX_KIDS] = { "cond", "body", "increment", "init" };
+    static const char* named[AST_MAX_KIDS] = { "left", "index", "", "" };
+    static const char* operands[AST_MAX_KIDS] = { "left", "right", "extra", "" };
+    
+    switch (type) {
+        case NODE_IF:
+        case NODE_IF_ELSE:
+        case NODE_WHILE:
+        case NODE_BLOCK:
+            return control[k];
+        case NODE_FOR:
+            return forLoop[k];
+        case NODE_ASSIGN:
+        case NODE_ARRAY_DECL:
+        case NODE_ARRAY_ACCESS:
+            return named[k];
+        case NODE_FUNCTION:
+            return k == KID_PARAMS ? "params" : "body";
+        case NODE_CALL:
+            return "args";
+        default:
+            return operands[k];
+    }
+}
+
 // Imprime el AST con indentación
 void printAST(ASTNode* node, int indent) {
     if (!node) return;
@@ -411,71 +697,19 @@ void printAST(ASTNode* node, int indent) {
     
     printf(">\n");
     
-    // Imprimir hijos recursivamente
-    if (node->init) {
-        for (int i = 0; i < indent + 1; i++) printf("  ");
-        printf("[init]\n");
-        printAST(node->init, indent + 2);
-    }
-    
-    if (node->cond) {
-        for (int i = 0; i < indent + 1; i++) printf("  ");
-        printf("[cond]\n");
-        printAST(node->cond, indent + 2);
-    }
-    
-    if (node->body) {
-        for (int i = 0; i < indent + 1; i++) printf("  ");
-        printf("[body]\n");
-        printAST(node->body, indent + 2);
-    }
-    
-    if (node->elseBody) {
-        for (int i = 0; i < indent + 1; i++) printf("  ");
-        printf("[else]\n");
-        printAST(node->elseBody, indent + 2);
-    }
-    
-    if (node->left) {
-        for (int i = 0; i < indent + 1; i++) printf("  ");
-        printf("[left]\n");
-        printAST(node->left, indent + 2);
-    }
-    
-    if (node->right) {
-        for (int i = 0; i < indent + 1; i++) printf("  ");
-        printf("[right]\n");
-        printAST(node->right, indent + 2);
-    }
-    
-    if (node->extra) {
-        for (int i = 0; i < indent + 1; i++) printf("  ");
-        printf("[extra]\n");
-        printAST(node->extra, indent + 2);
-    }
-    
-    if (node->increment) {
-        for (int i = 0; i < indent + 1; i++) printf("  ");
-        printf("[increment]\n");
-        printAST(node->increment, indent + 2);
-    }
-    
-    if (node->index) {
-        for (int i = 0; i < indent + 1; i++) printf("  ");
-        printf("[index]\n");
-        printAST(node->index, indent + 2);
-    }
-    
-    if (node->params) {
-        for (int i = 0; i < indent + 1; i++) printf("  ");
-        printf("[params]\n");
-        printAST(node->params, indent + 2);
+    // Imprimir hijos recursivamente (init primero: es la única ranura 3)
+    if (node->type == NODE_SEQ) {
+        for (int i = 0; i < AST_STMT_COUNT(node); i++) {
+            printAST(AST_STMT(node, i), indent + 1);
+        }
     }
-    
-    if (node->args) {
-        for (int i = 0; i < indent + 1; i++) printf("  ");
-        printf("[args]\n");
-        printAST(node->args, indent + 2);
+    static const int order[AST_MAX_KIDS] = { KID_INIT, 0, 1, 2 };
+    for (int i = 0; i < AST_MAX_KIDS; i++) {
+        int k = order[i];
+        if (!node->kid[k]) continue;
+        for (int j = 0; j < indent + 1; j++) printf("  ");
+        printf("[%s]\n", kidLabel(node->type, k));
+        printAST(node->kid[k], indent + 2);
     }
     
     if (node->next) {
@@ -485,30 +719,38 @@ void printAST(ASTNode* node, int indent) {
     }
 }
 
-// Libera recursivamente la memoria del AST
+// Devuelve el subárbol a la lista libre (las cadenas quedan en la arena)
 void freeAST(ASTNode* node) {
     if (!node) return;
     
-    // Liberar strings
-    if (node->idName) free(node->idName);
-    if (node->stringValue) free(node->stringValue);
-    
     // Liberar hijos recursivamente
-    freeAST(node->left);
-    freeAST(node->right);
-    freeAST(node->extra);
-    freeAST(node->cond);
-    freeAST(node->body);
-    freeAST(node->elseBody);
-    freeAST(node->init);
-    freeAST(node->increment);
-    freeAST(node->params);
-    freeAST(node->args);
+    for (int k = 0; k < AST_KID_COUNT(node); k++) freeAST(AST_KIDS(node)[k]);
     freeAST(node->next);
-    freeAST(node->index);
     
     // Liberar el nodo
-    free(node);
+    freeNode(node);
+}
+
+// Copia profunda de un subárbol
+ASTNode* cloneAST(ASTNode* node) {
+    if (!node) return NULL;
+    
+    if (node->type == NODE_SEQ) {
+        ASTNode* copy = newSeqNode();
+        for (int i = 0; i < AST_STMT_COUNT(node); i++) {
+            seqAppend(copy, cloneAST(AST_STMT(node, i)));
+        }
+        return copy;
+    }
+    
+    // Las cadenas de la arena no se modifican ni se liberan: se comparten
+    ASTNode* copy = initNode();
+    *copy = *node;
+    
+    for (int k = 0; k < AST_MAX_KIDS; k++) copy->kid[k] = cloneAST(node->kid[k]);
+    copy->next = cloneAST(node->next);
+    
+    return copy;
 }
 
 /* ============================================================
@@ -521,18 +763,8 @@ int countNodes(ASTNode* node) {
     
     int count = 1; // Este nodo
     
-    count += countNodes(node->left);
-    count += countNodes(node->right);
-    count += countNodes(node->extra);
-    count += countNodes(node->cond);
-    count += countNodes(node->body);
-    count += countNodes(node->elseBody);
-    count += countNodes(node->init);
-    count += countNodes(node->increment);
-    count += countNodes(node->params);
-    count += countNodes(node->args);
+    for (int k = 0; k < AST_KID_COUNT(node); k++) count += countNodes(AST_KIDS(node)[k]);
     count += countNodes(node->next);
-    count += countNodes(node->index);
     
     return count;
 }
@@ -541,25 +773,11 @@ int countNodes(ASTNode* node) {
 int treeDepth(ASTNode* node) {
     if (!node) return 0;
     
-    int depths[12] = {
-        treeDepth(node->left),
-        treeDepth(node->right),
-        treeDepth(node->extra),
-        treeDepth(node->cond),
-        treeDepth(node->body),
-        treeDepth(node->elseBody),
-        treeDepth(node->init),
-        treeDepth(node->increment),
-        treeDepth(node->params),
-        treeDepth(node->args),
-        treeDepth(node->next),
-        treeDepth(node->index)
-    };
-    
-    int maxDepth = 0;
-    for (int i = 0; i < 12; i++) {
-        if (depths[i] > maxDepth) {
-            maxDepth = depths[i];
+    int maxDepth = treeDepth(node->next);
+    for (int k = 0; k < AST_KID_COUNT(node); k++) {
+        int depth = treeDepth(AST_KIDS(node)[k]);
+        if (depth > maxDepth) {
+            maxDepth = depth;
         }
     }
     
@@ -2,6 +2,8 @@
 #ifndef AST_H
 #define AST_H
 
+#include <stddef.h>
+
 // Tipos de variables
 typedef enum {
     TYPE_INT_T,
@@ -51,41 +53,79 @@ typedef enum {
     NODE_BLOCK
 } NodeType;
 
-// Nodo del AST
+// Ranuras de hijos. Cada tipo de nodo usa solo las que le corresponden y
+// dos papeles con el mismo número nunca aparecen en el mismo nodo:
+//   operadores, PRINT, RETURN:       left, right
+//   PIXEL:                           left (x), right (y), extra (color)
+//   ASSIGN, ARRAY_DECL:              left (valor o tamaño), index
+//   ARRAY_ACCESS:                    index
+//   IF, IF_ELSE, WHILE, BLOCK:       cond, body, elseBody
+//   FOR:                             cond, body, increment, init
+//   FUNCTION:                        params, body
+//   CALL:                            args
+// SEQ no usa ranuras: guarda sus sentencias en un arreglo contiguo (stmts).
+enum {
+    KID_LEFT = 0,
+    KID_RIGHT = 1,
+    KID_EXTRA = 2,
+    KID_COND = 0,
+    KID_BODY = 1,
+    KID_ELSE = 2,
+    KID_INCREMENT = 2,
+    KID_INIT = 3,
+    KID_INDEX = 1,
+    KID_PARAMS = 0,
+    KID_ARGS = 0,
+    AST_MAX_KIDS = 4
+};
+
+// Sentencias de un NODE_SEQ, en orden de ejecución
+typedef struct StmtList {
+    int count;
+    int capacity;
+    struct ASTNode* items[];
+} StmtList;
+
+// Nodo del AST (64 bytes: una línea de caché)
 typedef struct ASTNode {
     NodeType type;
-    VarType varType;
+    VarType varType;            // Declarado, o calculado por checkSemantics
     
-    // Valores literales
-    int intValue;
-    float floatValue;
+    struct ASTNode *kid[AST_MAX_KIDS];
+    struct ASTNode *next;       // Listas de parámetros y argumentos
     char* idName;
-    char* stringValue;
-    
-    // Expresiones binarias
-    struct ASTNode *left;
-    struct ASTNode *right;
-    struct ASTNode *extra;
-    
-    // Control de flujo
-    struct ASTNode *cond;
-    struct ASTNode *body;
-    struct ASTNode *elseBody;
-    
-    // For loop
-    struct ASTNode *init;
-    struct ASTNode *increment;
     
-    // Funciones
-    struct ASTNode *params;
-    struct ASTNode *args;
-    struct ASTNode *next;
-    
-    // Arreglos
-    struct ASTNode *index;
-    int arraySize;
+    // Dato propio de cada tipo de nodo
+    union {
+        int intValue;           // INT, BOOL, número de tecla en KEY
+        float floatValue;       // FLOAT
+        char* stringValue;      // STRING
+        int arraySize;          // ARRAY_DECL con tamaño literal
+        StmtList* stmts;        // SEQ
+    };
 } ASTNode;
 
+// Acceso a los hijos por su papel (se pueden asignar)
+#define AST_LEFT(n)      ((n)->kid[KID_LEFT])
+#define AST_RIGHT(n)     ((n)->kid[KID_RIGHT])
+#define AST_EXTRA(n)     ((n)->kid[KID_EXTRA])
+#define AST_COND(n)      ((n)->kid[KID_COND])
+#define AST_BODY(n)      ((n)->kid[KID_BODY])
+#define AST_ELSE(n)      ((n)->kid[KID_ELSE])
+#define AST_INCREMENT(n) ((n)->kid[KID_INCREMENT])
+#define AST_INIT(n)      ((n)->kid[KID_INIT])
+#define AST_INDEX(n)     ((n)->kid[KID_INDEX])
+#define AST_PARAMS(n)    ((n)->kid[KID_PARAMS])
+#define AST_ARGS(n)      ((n)->kid[KID_ARGS])
+
+// Sentencias de un NODE_SEQ
+#define AST_STMT_COUNT(n) ((n)->stmts->count)
+#define AST_STMT(n, i)    ((n)->stmts->items[(i)])
+
+// Todos los hijos de un nodo, para los recorridos genéricos
+#define AST_KID_COUNT(n) ((n)->type == NODE_SEQ ? AST_STMT_COUNT(n) : AST_MAX_KIDS)
+#define AST_KIDS(n)      ((n)->type == NODE_SEQ ? (n)->stmts->items : (n)->kid)
+
 // Variable global para el AST
 extern ASTNode* root;
 
@@ -104,6 +144,7 @@ ASTNode* newKey(int keyNum, char* dest);
 ASTNode* newInput(char* dest);
 ASTNode* newPrint(ASTNode* expr);
 ASTNode* newSeq(ASTNode* first, ASTNode* second);
+void seqAppend(ASTNode* seq, ASTNode* stmt);
 ASTNode* newBinOp(NodeType op, ASTNode* left, ASTNode* right);
 ASTNode* newUnaryOp(NodeType op, ASTNode* operand);
 ASTNode* newIf(ASTNode* cond, ASTNode* body);
@@ -114,9 +155,25 @@ ASTNode* newFunction(VarType retType, char* name, ASTNode* params, ASTNode* body
 ASTNode* newCall(char* name, ASTNode* args);
 ASTNode* newReturn(ASTNode* expr);
 ASTNode* newBlock(ASTNode* stmts);
+ASTNode* appendNext(ASTNode* list, ASTNode* item);
+void qualifyLocals(ASTNode* function);
+
+// Memoria: nodos y cadenas viven en una arena que se libera de una vez
+char* astStrdup(const char* str);
+char* intern(const char* name);
+int internId(const char* name);
+void markFunctionName(const char* name);
+int isFunctionName(const char* name);
+void freeNode(ASTNode* node);
+void freeASTArena();
+size_t astArenaBytes();
 
 // Utilidades
 void printAST(ASTNode* node, int indent);
 void freeAST(ASTNode* node);
+ASTNode* cloneAST(ASTNode* node);
+int countNodes(ASTNode* node);
+int treeDepth(ASTNode* node);
+void printASTStats(ASTNode* root);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,104 @@
+/* bench_symtable.c - Micro-benchmark de la tabla de símbolos
+ *
+ * Mide el throughput de búsquedas y del ciclo enterScope/addSymbol/exitScope.
+ * La rotación de scopes se repite con distintas cantidades de globales para
+ * mostrar que salir de un scope no depende del tamaño de la tabla.
+ *
+ * Uso: ./bench_symtable [nombres] [iteraciones]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "symtable.h"
+
+#define DEFAULT_NAMES 10000
+#define DEFAULT_ITERS 2000000
+#define LOCALS_PER_SCOPE 8
+
+static double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static char** makeNames(const char* prefix, int count) {
+    char** names = malloc(sizeof(char*) * count);
+    char buf[32];
+    for (int i = 0; i < count; i++) {
+        snprintf(buf, sizeof(buf), "%s%d", prefix, i);
+        names[i] = intern(buf);
+    }
+    return names;
+}
+
+// Declara 'count' globales y mide 'iters' búsquedas repartidas entre ellas
+static void benchLookup(char** globals, int count, int iters) {
+    initSymbolTable();
+    double start = now();
+    for (int i = 0; i < count; i++) {
+        addSymbol(globals[i], TYPE_INT_T, SYM_VARIABLE);
+    }
+    double inserted = now();
+
+    for (int i = 0; i < iters; i++) {
+        findSymbol(globals[(int)((long)i * 7919 % count)]);
+    }
+    double end = now();
+
+    printf("  %-28s %8d   %10.1f ns/op   %8.2f Mop/s\n", "inserción", count,
+           (inserted - start) * 1e9 / count, count / (inserted - start) / 1e6);
+    printf("  %-28s %8d   %10.1f ns/op   %8.2f Mop/s\n", "búsqueda", iters,
+           (end - inserted) * 1e9 / iters, iters / (end - inserted) / 1e6);
+}
+
+// Con 'count' globales declaradas, repite 'rounds' veces: entrar a un scope,
+// declarar LOCALS_PER_SCOPE locales, buscarlas y salir
+static void benchChurn(char** globals, int count, char** locals, int rounds) {
+    initSymbolTable();
+    for (int i = 0; i < count; i++) {
+        addSymbol(globals[i], TYPE_INT_T, SYM_VARIABLE);
+    }
+
+    double start = now();
+    for (int r = 0; r < rounds; r++) {
+        enterScope();
+        for (int k = 0; k < LOCALS_PER_SCOPE; k++) {
+            addSymbol(locals[k], TYPE_INT_T, SYM_VARIABLE);
+        }
+        for (int k = 0; k < LOCALS_PER_SCOPE; k++) {
+            findSymbol(locals[k]);
+        }
+        exitScope();
+    }
+    double end = now();
+
+    printf("  scopes con %6d globales    %8d   %10.1f ns/scope %8.2f Mscope/s\n",
+           count, rounds, (end - start) * 1e9 / rounds, rounds / (end - start) / 1e6);
+}
+
+int main(int argc, char** argv) {
+    int names = argc > 1 ? atoi(argv[1]) : DEFAULT_NAMES;
+    int iters = argc > 2 ? atoi(argv[2]) : DEFAULT_ITERS;
+    if (names < 1 || iters < 1) {
+        fprintf(stderr, "Uso: %s [nombres] [iteraciones]\n", argv[0]);
+        return 1;
+    }
+
+    char** globals = makeNames("g", names);
+    char** locals = makeNames("l", LOCALS_PER_SCOPE);
+
+    printf("Tabla de símbolos: %d nombres, %d iteraciones\n\n", names, iters);
+    printf("  %-28s %8s   %10s\n", "operación", "cantidad", "costo");
+    benchLookup(globals, names, iters);
+
+    printf("\n");
+    int rounds = iters / LOCALS_PER_SCOPE;
+    for (int count = 0; count <= names; count = count ? count * 10 : 10) {
+        benchChurn(globals, count, locals, rounds);
+    }
+
+    free(globals);
+    free(locals);
+    freeASTArena();
+    return 0;
+}
@@ -0,0 +1,686 @@
+/* cfg.c - Grafo de flujo de control, dominadores y forma SSA */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cfg.h"
+
+/*
+ * Dominadores con el algoritmo iterativo de Cooper, Harvey y Kennedy
+ * sobre el orden postorden inverso; fronteras de dominancia a partir de
+ * los dominadores inmediatos.
+ *
+ * La forma SSA es podada: un nombre recibe phis en la frontera de
+ * dominancia iterada de sus escrituras (Cytron et al.), pero solo en los
+ * bloques donde está vivo a la entrada. Los nombres que nunca están vivos
+ * entre bloques, como casi todos los temporales, no tienen phis. Donde
+ * un nombre está vivo, su versión actual en el recorrido del árbol de
+ * dominadores es exactamente el valor que guarda en el código; donde está
+ * muerto puede haber quedado una versión anterior (ver ssaLiveIn).
+ *
+ * Todos los recorridos usan pilas explícitas: los programas generados
+ * pueden tener miles de bloques anidados.
+ */
+
+/* ============================================================
+   GRAFO
+   ============================================================ */
+
+// Postorden inverso desde el bloque 0
+static void computeOrder(CFG* cfg) {
+    int n = cfg->blockCount;
+    int* stack = malloc(sizeof(int) * (n + 1));
+    int* next = calloc(n, sizeof(int));
+    char* visited = calloc(n, 1);
+    int* post = malloc(sizeof(int) * (n + 1));
+    int postCount = 0;
+    int top = 0;
+
+    if (n > 0) {
+        stack[top++] = 0;
+        visited[0] = 1;
+    }
+    while (top > 0) {
+        int b = stack[top - 1];
+        if (next[b] < 2) {
+            int s = cfg->succ[2 * b + next[b]++];
+            if (s >= 0 && !visited[s]) {
+                visited[s] = 1;
+                stack[top++] = s;
+            }
+            continue;
+        }
+        post[postCount++] = b;
+        top--;
+    }
+
+    cfg->rpo = malloc(sizeof(int) * (postCount + 1));
+    cfg->rpoIndex = malloc(sizeof(int) * (n + 1));
+    for (int b = 0; b < n; b++) cfg->rpoIndex[b] = -1;
+    for (int k = 0; k < postCount; k++) {
+        cfg->rpo[k] = post[postCount - 1 - k];
+        cfg->rpoIndex[cfg->rpo[k]] = k;
+    }
+    cfg->reachableCount = postCount;
+
+    free(stack);
+    free(next);
+    free(visited);
+    free(post);
+}
+
+static int intersect(CFG* cfg, int a, int b) {
+    while (a != b) {
+        while (cfg->rpoIndex[a] > cfg->rpoIndex[b]) a = cfg->idom[a];
+        while (cfg->rpoIndex[b] > cfg->rpoIndex[a]) b = cfg->idom[b];
+    }
+    return a;
+}
+
+static void computeDominators(CFG* cfg) {
+    int n = cfg->blockCount;
+    cfg->idom = malloc(sizeof(int) * (n + 1));
+    for (int b = 0; b < n; b++) cfg->idom[b] = -1;
+    if (cfg->reachableCount == 0) return;
+
+    int entry = cfg->rpo[0];
+    cfg->idom[entry] = entry;
+    int changed = 1;
+    while (changed) {
+        changed = 0;
+        for (int k = 1; k < cfg->reachableCount; k++) {
+            int b = cfg->rpo[k];
+            int newIdom = -1;
+            for (int p = cfg->predStart[b]; p < cfg->predStart[b + 1]; p++) {
+                int pred = cfg->preds[p];
+                if (cfg->idom[pred] < 0) continue;
+                newIdom = newIdom < 0 ? pred : intersect(cfg, pred, newIdom);
+            }
+            if (newIdom != cfg->idom[b]) {
+                cfg->idom[b] = newIdom;
+                changed = 1;
+            }
+        }
+    }
+}
+
+// Hijos del árbol de dominadores y numeración en preorden
+static void computeDomTree(CFG* cfg) {
+    int n = cfg->blockCount;
+    cfg->childStart = calloc(n + 2, sizeof(int));
+    cfg->children = malloc(sizeof(int) * (n + 1));
+    cfg->domPre = malloc(sizeof(int) * (n + 1));
+    cfg->domLast = malloc(sizeof(int) * (n + 1));
+
+    for (int b = 0; b < n; b++) {
+        cfg->domPre[b] = -1;
+        cfg->domLast[b] = -1;
+        int d = cfg->idom[b];
+        if (d >= 0 && d != b) cfg->childStart[d + 1]++;
+    }
+    for (int b = 0; b < n; b++) cfg->childStart[b + 1] += cfg->childStart[b];
+    int* fill = malloc(sizeof(int) * (n + 1));
+    memcpy(fill, cfg->childStart, sizeof(int) * (n + 1));
+    for (int k = 0; k < cfg->reachableCount; k++) {
+        int b = cfg->rpo[k];
+        int d = cfg->idom[b];
+        if (d >= 0 && d != b) cfg->children[fill[d]++] = b;
+    }
+    free(fill);
+
+    if (cfg->reachableCount == 0) return;
+
+    // Preorden; domLast se fija al salir de cada subárbol
+    int* stack = malloc(sizeof(int) * (2 * n + 2));
+    int top = 0;
+    int counter = 0;
+    stack[top++] = cfg->rpo[0];
+    while (top > 0) {
+        int item = stack[--top];
+        if (item < 0) {
+            cfg->domLast[-item - 1] = counter - 1;
+            continue;
+        }
+        cfg->domPre[item] = counter++;
+        stack[top++] = -item - 1;
+        for (int c = cfg->childStart[item + 1] - 1; c >= cfg->childStart[item]; c--) {
+            stack[top++] = cfg->children[c];
+        }
+    }
+    free(stack);
+}
+
+static void computeFrontiers(CFG* cfg) {
+    int n = cfg->blockCount;
+    int* mark = malloc(sizeof(int) * (n + 1));
+    cfg->frontierStart = calloc(n + 2, sizeof(int));
+
+    // Dos recorridos: contar y luego llenar
+    for (int pass = 0; pass < 2; pass++) {
+        int* fill = NULL;
+        if (pass == 1) {
+            for (int b = 0; b < n; b++) cfg->frontierStart[b + 1] += cfg->frontierStart[b];
+            cfg->frontier = malloc(sizeof(int) * (cfg->frontierStart[n] + 1));
+            fill = malloc(sizeof(int) * (n + 1));
+            memcpy(fill, cfg->frontierStart, sizeof(int) * (n + 1));
+        }
+        for (int b = 0; b < n; b++) mark[b] = -1;
+
+        for (int b = 0; b < n; b++) {
+            if (cfg->idom[b] < 0) continue;
+            if (cfg->predStart[b + 1] - cfg->predStart[b] < 2) continue;
+            for (int p = cfg->predStart[b]; p < cfg->predStart[b + 1]; p++) {
+                int runner = cfg->preds[p];
+                if (cfg->idom[runner] < 0) continue;
+                while (runner != cfg->idom[b] && mark[runner] != b) {
+                    mark[runner] = b;
+                    if (pass == 0) {
+                        cfg->frontierStart[runner + 1]++;
+                    } else {
+                        cfg->frontier[fill[runner]++] = b;
+                    }
+                    runner = cfg->idom[runner];
+                }
+            }
+        }
+        free(fill);
+    }
+    free(mark);
+}
+
+CFG* cfgBuild(IRProgram* prog) {
+    irBuildBlocks(prog);
+
+    CFG* cfg = malloc(sizeof(CFG));
+    int n = prog->blockCount;
+    cfg->prog = prog;
+    cfg->blockCount = n;
+
+    // Sucesores y predecesores
+    int* labelBlock = irLabelBlockMap(prog, NULL);
+    cfg->succ = malloc(sizeof(int) * (2 * n + 2));
+    cfg->predStart = calloc(n + 2, sizeof(int));
+    for (int b = 0; b < n; b++) {
+        int s[2];
+        int count = irBlockSuccessors(prog, b, labelBlock, s);
+        cfg->succ[2 * b] = count > 0 ? s[0] : -1;
+        cfg->succ[2 * b + 1] = count > 1 ? s[1] : -1;
+        // Un salto a la instrucción siguiente cuenta una sola vez
+        if (cfg->succ[2 * b + 1] == cfg->succ[2 * b]) cfg->succ[2 * b + 1] = -1;
+        for (int k = 0; k < 2; k++) {
+            if (cfg->succ[2 * b + k] >= 0) cfg->predStart[cfg->succ[2 * b + k] + 1]++;
+        }
+    }
+    free(labelBlock);
+
+    for (int b = 0; b < n; b++) cfg->predStart[b + 1] += cfg->predStart[b];
+    cfg->preds = malloc(sizeof(int) * (cfg->predStart[n] + 1));
+    int* fill = malloc(sizeof(int) * (n + 1));
+    memcpy(fill, cfg->predStart, sizeof(int) * (n + 1));
+    for (int b = 0; b < n; b++) {
+        for (int k = 0; k < 2; k++) {
+            int s = cfg->succ[2 * b + k];
+            if (s >= 0) cfg->preds[fill[s]++] = b;
+        }
+    }
+    free(fill);
+
+    computeOrder(cfg);
+    computeDominators(cfg);
+    computeDomTree(cfg);
+    computeFrontiers(cfg);
+    return cfg;
+}
+
+void cfgFree(CFG* cfg) {
+    if (!cfg) return;
+    free(cfg->succ);
+    free(cfg->predStart);
+    free(cfg->preds);
+    free(cfg->rpo);
+    free(cfg->rpoIndex);
+    free(cfg->idom);
+    free(cfg->childStart);
+    free(cfg->children);
+    free(cfg->domPre);
+    free(cfg->domLast);
+    free(cfg->frontierStart);
+    free(cfg->frontier);
+    free(cfg);
+}
+
+// 1 si el bloque a domina al bloque b (ambos alcanzables)
+int cfgDominates(CFG* cfg, int a, int b) {
+    if (cfg->domPre[a] < 0 || cfg->domPre[b] < 0) return 0;
+    return cfg->domPre[a] <= cfg->domPre[b] && cfg->domPre[b] <= cfg->domLast[a];
+}
+
+/* ============================================================
+   FORMA SSA
+   ============================================================ */
+
+int ssaSlot(IRInstr* ins, Operand* o) {
+    if (o == &ins->dst) return 0;
+    if (o == &ins->a) return 1;
+    if (o == &ins->b) return 2;
+    return 3;
+}
+
+// Nombre SSA de un operando (-1 si no es variable escalar ni temporal)
+int ssaName(SSAForm* ssa, Operand* o) {
+    if (o->kind == OPD_VAR) return o->id;
+    if (o->kind == OPD_TEMP) return ssa->varCount + o->num;
+    return -1;
+}
+
+static Operand* scalarDef(IRInstr* ins) {
+    Operand* def = irDef(ins);
+    if (def && (def->kind == OPD_VAR || def->kind == OPD_TEMP)) return def;
+    return NULL;
+}
+
+static int newVersion(SSAForm* ssa, int name, int def) {
+    int v = ssa->versionCount++;
+    ssa->versionName[v] = name;
+    ssa->versionDef[v] = def;
+    return v;
+}
+
+// Listas aplanadas por nombre: los bloques de x son
+// block[start[x]] .. block[start[x + 1] - 1]
+typedef struct {
+    int* start;
+    int* block;
+} NameBlocks;
+
+static void freeNameBlocks(NameBlocks* list) {
+    free(list->start);
+    free(list->block);
+}
+
+// Bloques alcanzables que escriben cada nombre (defs) y que lo leen antes
+// de escribirlo (exposed), en orden postorden inverso
+static void collectBlocks(SSAForm* ssa, NameBlocks* defs, NameBlocks* exposed) {
+    CFG* cfg = ssa->cfg;
+    IRProgram* prog = cfg->prog;
+    int names = ssa->nameCount;
+    int* defFill = NULL;
+    int* useFill = NULL;
+    int* lastDef = malloc(sizeof(int) * (names + 1));
+    int* lastUse = malloc(sizeof(int) * (names + 1));
+
+    defs->start = calloc(names + 2, sizeof(int));
+    exposed->start = calloc(names + 2, sizeof(int));
+    defs->block = exposed->block = NULL;
+
+    // Dos recorridos: contar y luego llenar
+    for (int pass = 0; pass < 2; pass++) {
+        if (pass == 1) {
+            for (int x = 0; x < names; x++) {
+                defs->start[x + 1] += defs->start[x];
+                exposed->start[x + 1] += exposed->start[x];
+            }
+            defs->block = malloc(sizeof(int) * (defs->start[names] + 1));
+            exposed->block = malloc(sizeof(int) * (exposed->start[names] + 1));
+            defFill = malloc(sizeof(int) * (names + 1));
+            useFill = malloc(sizeof(int) * (names + 1));
+            memcpy(defFill, defs->start, sizeof(int) * (names + 1));
+            memcpy(useFill, exposed->start, sizeof(int) * (names + 1));
+        }
+        for (int x = 0; x < names; x++) lastDef[x] = lastUse[x] = -1;
+
+        for (int k = 0; k < cfg->reachableCount; k++) {
+            int b = cfg->rpo[k];
+            for (int i = prog->blocks[b].start; i < prog->blocks[b].end; i++) {
+                IRInstr* ins = &prog->code[i];
+                Operand* uses[3];
+                int count = irUses(ins, uses);
+                for (int u = 0; u < count; u++) {
+                    int x = ssaName(ssa, uses[u]);
+                    if (x < 0 || lastDef[x] == b || lastUse[x] == b) continue;
+                    lastUse[x] = b;
+                    if (pass == 0) {
+                        exposed->start[x + 1]++;
+                    } else {
+                        exposed->block[useFill[x]++] = b;
+                    }
+                }
+                Operand* def = scalarDef(ins);
+                if (!def) continue;
+                int x = ssaName(ssa, def);
+                if (lastDef[x] == b) continue;
+                lastDef[x] = b;
+                if (pass == 0) {
+                    defs->start[x + 1]++;
+                } else {
+                    defs->block[defFill[x]++] = b;
+                }
+            }
+        }
+    }
+    free(defFill);
+    free(useFill);
+    free(lastDef);
+    free(lastUse);
+}
+
+// Vida a la entrada de cada bloque: para cada nombre, lista de trabajo
+// hacia atrás por los predecesores desde los bloques que lo leen antes de
+// escribirlo, sin atravesar los que lo escriben. El costo es proporcional
+// al tamaño de los conjuntos vivos. Deja en live los bloques de cada
+// nombre y en ssa->live los nombres de cada bloque.
+static void computeLiveness(SSAForm* ssa, NameBlocks* defs, NameBlocks* exposed,
+                            NameBlocks* live) {
+    CFG* cfg = ssa->cfg;
+    int n = cfg->blockCount;
+    int names = ssa->nameCount;
+    int* killed = malloc(sizeof(int) * (n + 1));
+    int* inLive = malloc(sizeof(int) * (n + 1));
+    int* work = malloc(sizeof(int) * (n + 1));
+    int capacity = 256;
+    for (int b = 0; b < n; b++) killed[b] = inLive[b] = -1;
+
+    live->start = calloc(names + 2, sizeof(int));
+    live->block = malloc(sizeof(int) * capacity);
+    int count = 0;
+
+    for (int x = 0; x < names; x++) {
+        live->start[x] = count;
+        for (int d = defs->start[x]; d < defs->start[x + 1]; d++) killed[defs->block[d]] = x;
+        int top = 0;
+        for (int u = exposed->start[x]; u < exposed->start[x + 1]; u++) {
+            inLive[exposed->block[u]] = x;
+            work[top++] = exposed->block[u];
+        }
+        while (top > 0) {
+            int b = work[--top];
+            if (count == capacity) {
+                capacity *= 2;
+                live->block = realloc(live->block, sizeof(int) * capacity);
+            }
+            live->block[count++] = b;
+            for (int p = cfg->predStart[b]; p < cfg->predStart[b + 1]; p++) {
+                int pred = cfg->preds[p];
+                if (cfg->rpoIndex[pred] < 0 || inLive[pred] == x || killed[pred] == x) continue;
+                inLive[pred] = x;
+                work[top++] = pred;
+            }
+        }
+    }
+    live->start[names] = count;
+
+    // Transponer por bloque: cada lista queda ordenada por nombre
+    ssa->liveStart = calloc(n + 2, sizeof(int));
+    ssa->live = malloc(sizeof(int) * (count + 1));
+    for (int k = 0; k < count; k++) ssa->liveStart[live->block[k] + 1]++;
+    for (int b = 0; b < n; b++) ssa->liveStart[b + 1] += ssa->liveStart[b];
+    int* fill = malloc(sizeof(int) * (n + 1));
+    memcpy(fill, ssa->liveStart, sizeof(int) * (n + 1));
+    for (int x = 0; x < names; x++) {
+        for (int k = live->start[x]; k < live->start[x + 1]; k++) {
+            ssa->live[fill[live->block[k]]++] = x;
+        }
+    }
+
+    free(fill);
+    free(killed);
+    free(inLive);
+    free(work);
+}
+
+// Coloca phis en la frontera de dominancia iterada de las escrituras,
+// solo en los bloques donde el nombre está vivo a la entrada
+static void placePhis(SSAForm* ssa, NameBlocks* defs, NameBlocks* live) {
+    CFG* cfg = ssa->cfg;
+    int n = cfg->blockCount;
+    int* inFrontier = malloc(sizeof(int) * (n + 1));
+    int* queued = malloc(sizeof(int) * (n + 1));
+    int* isLive = malloc(sizeof(int) * (n + 1));
+    int* work = malloc(sizeof(int) * (n + 1));
+    int* phiBlock = NULL;
+    int* phiName = NULL;
+    int capacity = 0;
+    for (int b = 0; b < n; b++) inFrontier[b] = queued[b] = isLive[b] = -1;
+
+    for (int x = 0; x < ssa->nameCount; x++) {
+        // Un nombre que no está vivo a la entrada de ningún bloque (casi
+        // todos los temporales) no necesita phis
+        if (live->start[x + 1] == live->start[x]) continue;
+        if (defs->start[x + 1] == defs->start[x]) continue;
+        for (int k = live->start[x]; k < live->start[x + 1]; k++) isLive[live->block[k]] = x;
+
+        // Frontera iterada con una lista de trabajo
+        int top = 0;
+        for (int d = defs->start[x]; d < defs->start[x + 1]; d++) {
+            work[top++] = defs->block[d];
+            queued[defs->block[d]] = x;
+        }
+        while (top > 0) {
+            int b = work[--top];
+            for (int f = cfg->frontierStart[b]; f < cfg->frontierStart[b + 1]; f++) {
+                int y = cfg->frontier[f];
+                if (inFrontier[y] == x) continue;
+                inFrontier[y] = x;
+                if (isLive[y] == x) {
+                    if (ssa->phiCount == capacity) {
+                        capacity = capacity ? capacity * 2 : 64;
+                        phiBlock = realloc(phiBlock, sizeof(int) * capacity);
+                        phiName = realloc(phiName, sizeof(int) * capacity);
+                    }
+                    phiBlock[ssa->phiCount] = y;
+                    phiName[ssa->phiCount] = x;
+                    ssa->phiCount++;
+                }
+                if (queued[y] != x) {
+                    queued[y] = x;
+                    work[top++] = y;
+                }
+            }
+        }
+    }
+
+    // Agrupar por bloque (orden estable)
+    ssa->phiStart = calloc(n + 2, sizeof(int));
+    for (int p = 0; p < ssa->phiCount; p++) ssa->phiStart[phiBlock[p] + 1]++;
+    for (int b = 0; b < n; b++) ssa->phiStart[b + 1] += ssa->phiStart[b];
+    ssa->phis = malloc(sizeof(SSAPhi) * (ssa->phiCount + 1));
+    int* phiFill = malloc(sizeof(int) * (n + 1));
+    memcpy(phiFill, ssa->phiStart, sizeof(int) * (n + 1));
+    for (int p = 0; p < ssa->phiCount; p++) {
+        int b = phiBlock[p];
+        SSAPhi* phi = &ssa->phis[phiFill[b]++];
+        int arity = cfg->predStart[b + 1] - cfg->predStart[b];
+        phi->block = b;
+        phi->name = phiName[p];
+        phi->dst = -1;
+        phi->args = malloc(sizeof(int) * (arity + 1));
+        for (int a = 0; a < arity; a++) phi->args[a] = -1;
+    }
+
+    free(phiFill);
+    free(phiBlock);
+    free(phiName);
+    free(inFrontier);
+    free(queued);
+    free(isLive);
+    free(work);
+}
+
+// 1 si el nombre está vivo a la entrada del bloque (búsqueda binaria)
+int ssaLiveIn(SSAForm* ssa, int block, int name) {
+    int lo = ssa->liveStart[block];
+    int hi = ssa->liveStart[block + 1] - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        if (ssa->live[mid] == name) return 1;
+        if (ssa->live[mid] < name) {
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return 0;
+}
+
+// Renombrado en preorden del árbol de dominadores
+static void renameVersions(SSAForm* ssa) {
+    CFG* cfg = ssa->cfg;
+    IRProgram* prog = cfg->prog;
+    int n = cfg->blockCount;
+
+    int* current = malloc(sizeof(int) * (ssa->nameCount + 1));
+    for (int x = 0; x < ssa->nameCount; x++) current[x] = ssa->entryVersion[x];
+
+    // Registro para deshacer: (nombre, versión anterior)
+    int logCapacity = 256;
+    int* logName = malloc(sizeof(int) * logCapacity);
+    int* logOld = malloc(sizeof(int) * logCapacity);
+    int logTop = 0;
+
+    int* stack = malloc(sizeof(int) * (2 * n + 2));
+    int* mark = malloc(sizeof(int) * (n + 1));
+    int top = 0;
+    if (cfg->reachableCount > 0) stack[top++] = cfg->rpo[0];
+
+    while (top > 0) {
+        int item = stack[--top];
+        if (item < 0) {
+            int b = -item - 1;
+            while (logTop > mark[b]) {
+                logTop--;
+                current[logName[logTop]] = logOld[logTop];
+            }
+            continue;
+        }
+
+        int b = item;
+        mark[b] = logTop;
+
+        // Escrituras del bloque: phis y luego instrucciones
+        int pendingDefs = (ssa->phiStart[b + 1] - ssa->phiStart[b]) +
+                          (prog->blocks[b].end - prog->blocks[b].start);
+        if (logTop + pendingDefs > logCapacity) {
+            while (logTop + pendingDefs > logCapacity) logCapacity *= 2;
+            logName = realloc(logName, sizeof(int) * logCapacity);
+            logOld = realloc(logOld, sizeof(int) * logCapacity);
+        }
+
+        for (int p = ssa->phiStart[b]; p < ssa->phiStart[b + 1]; p++) {
+            SSAPhi* phi = &ssa->phis[p];
+            phi->dst = newVersion(ssa, phi->name, -2);
+            logName[logTop] = phi->name;
+            logOld[logTop++] = current[phi->name];
+            current[phi->name] = phi->dst;
+        }
+
+        for (int i = prog->blocks[b].start; i < prog->blocks[b].end; i++) {
+            IRInstr* ins = &prog->code[i];
+            Operand* uses[3];
+            int count = irUses(ins, uses);
+            for (int k = 0; k < count; k++) {
+                int x = ssaName(ssa, uses[k]);
+                if (x >= 0) ssa->opVersion[i * 4 + ssaSlot(ins, uses[k])] = current[x];
+            }
+            Operand* def = scalarDef(ins);
+            if (def) {
+                int x = ssaName(ssa, def);
+                int v = newVersion(ssa, x, i);
+                ssa->opVersion[i * 4] = v;
+                logName[logTop] = x;
+                logOld[logTop++] = current[x];
+                current[x] = v;
+            }
+        }
+
+        // Argumentos de los phis de los sucesores
+        for (int k = 0; k < 2; k++) {
+            int s = cfg->succ[2 * b + k];
+            if (s < 0) continue;
+            for (int q = cfg->predStart[s]; q < cfg->predStart[s + 1]; q++) {
+                if (cfg->preds[q] != b) continue;
+                int arg = q - cfg->predStart[s];
+                for (int p = ssa->phiStart[s]; p < ssa->phiStart[s + 1]; p++) {
+                    ssa->phis[p].args[arg] = current[ssa->phis[p].name];
+                }
+            }
+        }
+
+        stack[top++] = -b - 1;
+        for (int c = cfg->childStart[b + 1] - 1; c >= cfg->childStart[b]; c--) {
+            stack[top++] = cfg->children[c];
+        }
+    }
+
+    free(current);
+    free(logName);
+    free(logOld);
+    free(stack);
+    free(mark);
+}
+
+// Cadenas definición-uso a partir de las versiones de cada lectura
+static void buildUseChains(SSAForm* ssa) {
+    int slots = ssa->cfg->prog->count * 4;
+    ssa->useStart = calloc(ssa->versionCount + 2, sizeof(int));
+    for (int s = 0; s < slots; s++) {
+        if (s % 4 != 0 && ssa->opVersion[s] >= 0) ssa->useStart[ssa->opVersion[s] + 1]++;
+    }
+    for (int v = 0; v < ssa->versionCount; v++) ssa->useStart[v + 1] += ssa->useStart[v];
+    ssa->uses = malloc(sizeof(int) * (ssa->useStart[ssa->versionCount] + 1));
+    int* fill = malloc(sizeof(int) * (ssa->versionCount + 1));
+    memcpy(fill, ssa->useStart, sizeof(int) * (ssa->versionCount + 1));
+    for (int s = 0; s < slots; s++) {
+        if (s % 4 != 0 && ssa->opVersion[s] >= 0) ssa->uses[fill[ssa->opVersion[s]]++] = s;
+    }
+    free(fill);
+}
+
+SSAForm* ssaBuild(CFG* cfg) {
+    IRProgram* prog = cfg->prog;
+    SSAForm* ssa = malloc(sizeof(SSAForm));
+    ssa->cfg = cfg;
+    ssa->varCount = irNumberVariables(prog);
+    ssa->nameCount = ssa->varCount + irMaxTemp(prog);
+    ssa->phis = NULL;
+    ssa->phiCount = 0;
+
+    ssa->opVersion = malloc(sizeof(int) * (prog->count * 4 + 1));
+    for (int s = 0; s < prog->count * 4; s++) ssa->opVersion[s] = -1;
+
+    NameBlocks defs, exposed, live;
+    collectBlocks(ssa, &defs, &exposed);
+    computeLiveness(ssa, &defs, &exposed, &live);
+    placePhis(ssa, &defs, &live);
+    freeNameBlocks(&defs);
+    freeNameBlocks(&exposed);
+    freeNameBlocks(&live);
+
+    // Cota de versiones: entradas + escrituras + phis
+    int maxVersions = ssa->nameCount + prog->count + ssa->phiCount + 1;
+    ssa->versionName = malloc(sizeof(int) * maxVersions);
+    ssa->versionDef = malloc(sizeof(int) * maxVersions);
+    ssa->entryVersion = malloc(sizeof(int) * (ssa->nameCount + 1));
+    ssa->versionCount = 0;
+    for (int x = 0; x < ssa->nameCount; x++) {
+        ssa->entryVersion[x] = newVersion(ssa, x, -1);
+    }
+
+    renameVersions(ssa);
+    buildUseChains(ssa);
+    return ssa;
+}
+
+void ssaFree(SSAForm* ssa) {
+    if (!ssa) return;
+    for (int p = 0; p < ssa->phiCount; p++) free(ssa->phis[p].args);
+    free(ssa->phis);
+    free(ssa->phiStart);
+    free(ssa->opVersion);
+    free(ssa->versionName);
+    free(ssa->versionDef);
+    free(ssa->entryVersion);
+    free(ssa->useStart);
+    free(ssa->uses);
+    free(ssa->liveStart);
+    free(ssa->live);
+    free(ssa);
+}
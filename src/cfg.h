@@ -0,0 +1,78 @@
+/* cfg.h - Grafo de flujo de control, dominadores y forma SSA */
+#ifndef CFG_H
+#define CFG_H
+
+#include "ir.h"
+
+// Grafo de flujo sobre los bloques básicos de un IRProgram.
+// Las listas de predecesores, hijos y fronteras están aplanadas:
+// los de b son list[start[b]] .. list[start[b + 1] - 1].
+typedef struct {
+    IRProgram* prog;
+    int blockCount;
+
+    int* succ;          // Dos sucesores por bloque (-1 si no hay)
+    int* predStart;
+    int* preds;
+
+    int* rpo;           // Bloques alcanzables en orden postorden inverso
+    int reachableCount;
+    int* rpoIndex;      // Posición en rpo (-1 si es inalcanzable)
+
+    int* idom;          // Dominador inmediato (-1 si es inalcanzable)
+    int* childStart;    // Hijos en el árbol de dominadores
+    int* children;
+    int* domPre;        // Numeración en preorden del árbol
+    int* domLast;       // Último número de preorden del subárbol
+
+    int* frontierStart; // Frontera de dominancia
+    int* frontier;
+} CFG;
+
+// Nodo phi: dst = phi(args[0..n-1]), un argumento por predecesor
+typedef struct {
+    int block;
+    int name;
+    int dst;
+    int* args;
+} SSAPhi;
+
+// Forma SSA sobre nombres: las instrucciones conservan sus operandos y
+// cada lectura/escritura de variable escalar o temporal se anota con su
+// versión. Como el código nunca se reescribe, salir de SSA se reduce a
+// descartar las anotaciones (ssaFree).
+typedef struct {
+    CFG* cfg;
+    int varCount;       // Nombres [0, varCount): variables por id
+    int nameCount;      // Nombres [varCount, nameCount): temporales
+
+    int* opVersion;     // Versión de cada operando: [instr * 4 + ranura]
+    int versionCount;
+    int* versionName;   // Nombre al que pertenece cada versión
+    int* versionDef;    // Instrucción que la define (-1 entrada, -2 phi)
+    int* entryVersion;  // Versión inicial de cada nombre
+
+    SSAPhi* phis;       // Agrupados por bloque
+    int phiCount;
+    int* phiStart;      // Phis de b: phis[phiStart[b]] .. phis[phiStart[b + 1] - 1]
+
+    int* useStart;      // Cadenas definición-uso: ranuras que leen cada versión
+    int* uses;
+
+    int* liveStart;     // Nombres vivos a la entrada de b, ordenados:
+    int* live;          // live[liveStart[b]] .. live[liveStart[b + 1] - 1]
+} SSAForm;
+
+// Construcción del grafo (reconstruye los bloques básicos)
+CFG* cfgBuild(IRProgram* prog);
+void cfgFree(CFG* cfg);
+int cfgDominates(CFG* cfg, int a, int b);
+
+// Forma SSA podada sobre el grafo
+SSAForm* ssaBuild(CFG* cfg);
+void ssaFree(SSAForm* ssa);
+int ssaName(SSAForm* ssa, Operand* o);
+int ssaSlot(IRInstr* ins, Operand* o);
+int ssaLiveIn(SSAForm* ssa, int block, int name);
+
+#endif
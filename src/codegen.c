@@ -8,33 +8,105 @@
 int labelCount = 0;
 int tempCount = 0;
 
-// Tabla de variables ya declaradas (para evitar duplicados)
-static char* declaredVars[1000];
+// Programa IR en construcción
+static IRProgram* ir = NULL;
+
+// Profundidad de anidamiento de bucles
+static int loopDepth = 0;
+
+// Funciones definidas. Convención de llamada sin pila: cada función tiene
+// celdas fijas para sus parámetros (funcion__param), el valor de retorno
+// (__ret_funcion) y el número del sitio de llamada (__ra_funcion). Al
+// terminar, una cadena de IFEQ sobre ese número regresa al sitio correcto.
+typedef struct {
+    ASTNode* node;
+    int entryLabel;
+    int exitLabel;
+    char* resultVar;
+    char* returnVar;
+    int* sites;             // Etiqueta de regreso de cada llamada
+    int siteCount;
+    int siteCapacity;
+} FunctionInfo;
+
+static FunctionInfo* functions = NULL;
+static int functionCount = 0;
+static int functionCapacity = 0;
+static int currentFunction = -1;    // Función cuyo cuerpo se genera
+
+// Llamadas emitidas hasta ahora (para marcar los bucles que llaman)
+static int callCount = 0;
+
+static Operand generateValue(ASTNode* expr);
+
+// Conjunto hash de variables ya declaradas (direccionamiento abierto).
+// Los nombres están internados: el número del identificador es el hash y
+// se comparan por puntero. Crece al superar 3/4 de ocupación.
+#define DECLARED_INITIAL_CAPACITY 256
+
+static char** declaredVars = NULL;
+static int declaredCapacity = 0;
 static int declaredCount = 0;
 
-char* newTemp() {
-    char* temp = malloc(20);
-    sprintf(temp, "T%d", tempCount++);
-    declareVar(temp);
+static unsigned int hashName(const char* name) {
+    return (unsigned int)internId(name);
+}
+
+// Inserta sin verificar duplicados (usado al crecer la tabla)
+static void insertDeclared(char** table, int capacity, char* name) {
+    unsigned int i = hashName(name) & (capacity - 1);
+    while (table[i]) {
+        i = (i + 1) & (capacity - 1);
+    }
+    table[i] = name;
+}
+
+static void growDeclared() {
+    int newCapacity = declaredCapacity ? declaredCapacity * 2 : DECLARED_INITIAL_CAPACITY;
+    char** table = calloc(newCapacity, sizeof(char*));
+    if (!table) {
+        fprintf(stderr, "Error: No se pudo ampliar la tabla de declaraciones\n");
+        exit(1);
+    }
+    for (int i = 0; i < declaredCapacity; i++) {
+        if (declaredVars[i]) {
+            insertDeclared(table, newCapacity, declaredVars[i]);
+        }
+    }
+    free(declaredVars);
+    declaredVars = table;
+    declaredCapacity = newCapacity;
+}
+
+Operand newTemp() {
+    Operand temp = opTemp(tempCount++);
+    // Cada temporal es nuevo: se declara sin buscar duplicados
+    irEmit(ir, IR_VAR, temp, opNone(), opNone());
     return temp;
 }
 
-char* newLabel() {
-    char* label = malloc(20);
-    sprintf(label, "L%d", labelCount++);
-    return label;
+int newLabel() {
+    return labelCount++;
 }
 
-void declareVar(char* name) {
-    // Verificar si ya fue declarada
-    for (int i = 0; i < declaredCount; i++) {
-        if (strcmp(declaredVars[i], name) == 0) {
-            return; // Ya existe
+// Declara la variable si es nueva y retorna su nombre (internado)
+char* declareVar(char* name) {
+    if ((declaredCount + 1) * 4 > declaredCapacity * 3) {
+        growDeclared();
+    }
+    
+    unsigned int i = hashName(name) & (declaredCapacity - 1);
+    while (declaredVars[i]) {
+        if (declaredVars[i] == name) {
+            return declaredVars[i]; // Ya existe
         }
+        i = (i + 1) & (declaredCapacity - 1);
     }
     
-    printf("VAR %s\n", name);
-    declaredVars[declaredCount++] = strdup(name);
+    declaredVars[i] = name;
+    declaredCount++;
+    irEmit(ir, IR_VAR, opVar(declaredVars[i]), opNone(), opNone());
+    return declaredVars[i];
 }
 
 int getLabelCount() {
@@ -45,195 +117,366 @@ int getTempCount() {
     return tempCount;
 }
 
-// NUEVA FUNCIÓN: Optimizar expresiones constantes
-int isConstant(ASTNode* node) {
-    return node && (node->type == NODE_INT || 
-                    node->type == NODE_FLOAT || 
-                    node->type == NODE_BOOL);
+/* ============================================================
+   FUNCIONES
+   ============================================================ */
+
+static void registerFunction(ASTNode* node) {
+    if (functionCount == functionCapacity) {
+        functionCapacity = functionCapacity ? functionCapacity * 2 : 16;
+        functions = realloc(functions, sizeof(FunctionInfo) * functionCapacity);
+    }
+    FunctionInfo* fn = &functions[functionCount++];
+    fn->node = node;
+    fn->entryLabel = newLabel();
+    fn->exitLabel = newLabel();
+    char* name = malloc(strlen(node->idName) + 7);
+    sprintf(name, "__ret_%s", node->idName);
+    fn->resultVar = intern(name);
+    sprintf(name, "__ra_%s", node->idName);
+    fn->returnVar = intern(name);
+    free(name);
+    fn->sites = NULL;
+    fn->siteCount = 0;
+    fn->siteCapacity = 0;
 }
 
-char* generateExpr(ASTNode* node) {
-    if (!node) return NULL;
+static int findFunction(const char* name) {
+    for (int f = 0; f < functionCount; f++) {
+        if (functions[f].node->idName == name) return f;
+    }
+    return -1;
+}
+
+static void freeFunctions() {
+    for (int f = 0; f < functionCount; f++) {
+        free(functions[f].sites);
+    }
+    free(functions);
+    functions = NULL;
+    functionCount = 0;
+    functionCapacity = 0;
+}
+
+static int containsCall(ASTNode* node) {
+    if (!node) return 0;
+    if (node->type == NODE_CALL) return 1;
+    for (int k = 0; k < AST_KID_COUNT(node); k++) {
+        if (containsCall(AST_KIDS(node)[k])) return 1;
+    }
+    return 0;
+}
+
+// Copia los argumentos a los parámetros, guarda el número de sitio y
+// salta al cuerpo. Retorna el valor de retorno en un temporal (o nada).
+static Operand generateCall(ASTNode* node, int wantResult) {
+    int f = findFunction(node->idName);
+    if (f < 0) return opNone();
+
+    // Primero se evalúan todos los argumentos: uno puede llamar a otra
+    // función (o a la misma) que pisaría las celdas ya copiadas
+    int argCount = 0;
+    for (ASTNode* arg = AST_ARGS(node); arg; arg = arg->next) argCount++;
+    Operand* values = malloc(sizeof(Operand) * (argCount + 1));
+    int k = 0;
+    for (ASTNode* arg = AST_ARGS(node); arg; arg = arg->next, k++) {
+        values[k] = generateValue(arg);
+        // Una variable leída antes de otra llamada se copia: la llamada
+        // podría modificarla
+        int laterCall = 0;
+        for (ASTNode* rest = arg->next; rest; rest = rest->next) {
+            laterCall |= containsCall(rest);
+        }
+        if (laterCall && values[k].kind == OPD_VAR) {
+            Operand temp = newTemp();
+            irEmit(ir, IR_ASSIGN, temp, values[k], opNone());
+            values[k] = temp;
+        }
+    }
+
+    FunctionInfo* fn = &functions[f];
+    k = 0;
+    for (ASTNode* param = AST_PARAMS(fn->node); param; param = param->next, k++) {
+        irEmit(ir, IR_ASSIGN, opVar(declareVar(param->idName)), values[k], opNone());
+    }
+    free(values);
+
+    if (fn->siteCount == fn->siteCapacity) {
+        fn->siteCapacity = fn->siteCapacity ? fn->siteCapacity * 2 : 8;
+        fn->sites = realloc(fn->sites, sizeof(int) * fn->siteCapacity);
+    }
+    int returnLabel = newLabel();
+    int site = fn->siteCount;
+    fn->sites[fn->siteCount++] = returnLabel;
+    callCount++;
+
+    irEmit(ir, IR_ASSIGN, opVar(declareVar(fn->returnVar)), opInt(site), opNone());
+    irEmitJump(ir, IR_GOTO, opNone(), fn->entryLabel);
+    irEmitJump(ir, IR_LABEL, opNone(), returnLabel);
+
+    if (!wantResult) return opNone();
+    Operand result = newTemp();
+    irEmit(ir, IR_ASSIGN, result, opVar(declareVar(fn->resultVar)), opNone());
+    return result;
+}
+
+// Cuerpo de una función: LABEL de entrada, código, LABEL de salida y la
+// cadena que regresa a cada sitio de llamada
+void generateFunctionCode(ASTNode* node) {
+    int f = findFunction(node->idName);
+    if (f < 0 || functions[f].siteCount == 0) return;
+
+    currentFunction = f;
+    irEmitJump(ir, IR_LABEL, opNone(), functions[f].entryLabel);
+    generateCode(AST_BODY(node));
+    irEmitJump(ir, IR_LABEL, opNone(), functions[f].exitLabel);
+    currentFunction = -1;
+
+    FunctionInfo* fn = &functions[f];
+    for (int k = 0; k < fn->siteCount - 1; k++) {
+        IRInstr* jump = irEmitJump(ir, irCompareJumpFor(IR_EQ, 0),
+                                   opVar(declareVar(fn->returnVar)), fn->sites[k]);
+        jump->b = opInt(k);
+    }
+    irEmitJump(ir, IR_GOTO, opNone(), fn->sites[fn->siteCount - 1]);
+}
+
+// Construye el IR de todo el programa
+IRProgram* generateIR(ASTNode* root) {
+    ir = irCreate();
+    generateCode(root);
+    
+    // Las funciones van después del programa principal, de la última a la
+    // primera: una función solo llama a las definidas antes que ella, así
+    // que al generar cada una ya se conocen todos sus sitios de llamada.
+    // Las que nunca se llaman (o se expandieron en línea) no se generan.
+    int halted = 0;
+    for (int f = functionCount - 1; f >= 0; f--) {
+        if (functions[f].siteCount == 0) continue;
+        if (!halted) {
+            irEmit(ir, IR_RETURN, opNone(), opNone(), opNone());
+            halted = 1;
+        }
+        generateFunctionCode(functions[f].node);
+    }
+    freeFunctions();
+    
+    irBuildBlocks(ir);
+    return ir;
+}
+
+// Valor a asignar: literales y variables se usan directamente sin temporal
+static Operand generateValue(ASTNode* expr) {
+    switch (expr->type) {
+        case NODE_INT:
+        case NODE_BOOL:
+            return opInt(expr->intValue);
+        case NODE_FLOAT:
+            return opFloat(expr->floatValue);
+        case NODE_ID:
+            return opVar(expr->idName);
+        default:
+            return generateExpr(expr);
+    }
+}
+
+static IROpcode relationalOpcode(NodeType type) {
+    switch (type) {
+        case NODE_EQ:  return IR_EQ;
+        case NODE_NEQ: return IR_NEQ;
+        case NODE_LT:  return IR_LT;
+        case NODE_GT:  return IR_GT;
+        case NODE_LTE: return IR_LTE;
+        case NODE_GTE: return IR_GTE;
+        default:       return IR_NOP;
+    }
+}
+
+static int isTruthyLiteral(ASTNode* node, int* value) {
+    if (node->type == NODE_INT || node->type == NODE_BOOL) {
+        *value = node->intValue != 0;
+        return 1;
+    }
+    if (node->type == NODE_FLOAT) {
+        *value = node->floatValue != 0.0f;
+        return 1;
+    }
+    return 0;
+}
+
+// Salta a label si cond tiene el valor jumpIfTrue; si no, continúa.
+// && y || se evalúan en cortocircuito como cadenas de saltos.
+static void generateBranch(ASTNode* cond, int label, int jumpIfTrue) {
+    int value;
+    
+    switch (cond->type) {
+        case NODE_AND:
+            if (jumpIfTrue) {
+                int skip = newLabel();
+                generateBranch(AST_LEFT(cond), skip, 0);
+                generateBranch(AST_RIGHT(cond), label, 1);
+                irEmitJump(ir, IR_LABEL, opNone(), skip);
+            } else {
+                generateBranch(AST_LEFT(cond), label, 0);
+                generateBranch(AST_RIGHT(cond), label, 0);
+            }
+            return;
+        
+        case NODE_OR:
+            if (jumpIfTrue) {
+                generateBranch(AST_LEFT(cond), label, 1);
+                generateBranch(AST_RIGHT(cond), label, 1);
+            } else {
+                int skip = newLabel();
+                generateBranch(AST_LEFT(cond), skip, 1);
+                generateBranch(AST_RIGHT(cond), label, 0);
+                irEmitJump(ir, IR_LABEL, opNone(), skip);
+            }
+            return;
+        
+        case NODE_NOT:
+            generateBranch(AST_LEFT(cond), label, !jumpIfTrue);
+            return;
+        
+        default:
+            break;
+    }
+    
+    // Condición constante: salto incondicional o nada
+    if (isTruthyLiteral(cond, &value)) {
+        if (value == jumpIfTrue) {
+            irEmitJump(ir, IR_GOTO, opNone(), label);
+        }
+        return;
+    }
+    
+    // Comparación: un solo salto fusionado, sin temporal intermedio
+    IROpcode cmp = relationalOpcode(cond->type);
+    if (cmp != IR_NOP) {
+        Operand left = generateExpr(AST_LEFT(cond));
+        Operand right = generateExpr(AST_RIGHT(cond));
+        IRInstr* jump = irEmitJump(ir, irCompareJumpFor(cmp, !jumpIfTrue), left, label);
+        jump->b = right;
+        return;
+    }
+    
+    Operand v = generateExpr(cond);
+    irEmitJump(ir, jumpIfTrue ? IR_IFTRUE : IR_IFFALSE, v, label);
+}
+
+// && / || como valor: 1 o 0 en un temporal, con cortocircuito
+static Operand generateLogicalValue(ASTNode* node) {
+    Operand result = newTemp();
+    int labelEnd = newLabel();
+    
+    irEmit(ir, IR_ASSIGN, result, opInt(0), opNone());
+    generateBranch(node, labelEnd, 0);
+    irEmit(ir, IR_ASSIGN, result, opInt(1), opNone());
+    irEmitJump(ir, IR_LABEL, opNone(), labelEnd);
+    return result;
+}
+
+// Genera "OP left right Tn" y retorna el temporal
+static Operand generateBinary(ASTNode* node, IROpcode op) {
+    Operand left = generateExpr(AST_LEFT(node));
+    Operand right = generateExpr(AST_RIGHT(node));
+    Operand result = newTemp();
+    irEmit(ir, op, result, left, right);
+    return result;
+}
+
+Operand generateExpr(ASTNode* node) {
+    if (!node) return opNone();
     
     switch (node->type) {
         case NODE_INT: {
             // OPTIMIZACIÓN: Retornar el literal directamente si es pequeño
             if (node->intValue >= 0 && node->intValue <= 100) {
-                char* literal = malloc(20);
-                sprintf(literal, "%d", node->intValue);
-                return literal;
+                return opInt(node->intValue);
             }
-            char* temp = newTemp();
-            printf("ASSIGN %d %s\n", node->intValue, temp);
+            Operand temp = newTemp();
+            irEmit(ir, IR_ASSIGN, temp, opInt(node->intValue), opNone());
             return temp;
         }
         
         case NODE_FLOAT: {
-            char* temp = newTemp();
-            printf("ASSIGN %.6f %s\n", node->floatValue, temp);
+            Operand temp = newTemp();
+            irEmit(ir, IR_ASSIGN, temp, opFloat(node->floatValue), opNone());
             return temp;
         }
         
         case NODE_BOOL: {
-            char* temp = newTemp();
-            printf("ASSIGN %d %s\n", node->intValue, temp);
+            Operand temp = newTemp();
+            irEmit(ir, IR_ASSIGN, temp, opInt(node->intValue), opNone());
             return temp;
         }
         
         case NODE_ID:
-            return node->idName;
+            return opVar(node->idName);
         
         case NODE_ARRAY_ACCESS: {
-            // Simplificado: solo índices constantes
-            if (node->index->type == NODE_INT) {
-                char* varName = malloc(100);
-                sprintf(varName, "%s_%d", node->idName, node->index->intValue);
-                return varName;
-            } else {
-                // Índice dinámico - más complejo
-                char* indexVar = generateExpr(node->index);
-                char* temp = newTemp();
-                printf("// TODO: Acceso dinámico arr[%s]\n", indexVar);
-                return temp;
+            // Índice constante: la celda se direcciona como arr[k]
+            if (AST_INDEX(node)->type == NODE_INT) {
+                return opElem(node->idName, AST_INDEX(node)->intValue);
             }
+            // Índice dinámico: base del bloque + desplazamiento
+            Operand index = generateExpr(AST_INDEX(node));
+            Operand temp = newTemp();
+            irEmit(ir, IR_LOAD, temp, opVar(node->idName), index);
+            return temp;
         }
         
         case NODE_ARRAY_LENGTH: {
-            char* lengthVar = malloc(100);
+            char lengthVar[100];
             sprintf(lengthVar, "%s_length", node->idName);
-            return lengthVar;
+            return opVar(intern(lengthVar));
         }
         
-        // OPTIMIZACIÓN: Operaciones con constantes
-        case NODE_ADD: {
-            // Si ambos son constantes, no generar código
-            if (isConstant(node->left) && isConstant(node->right)) {
-                int result = node->left->intValue + node->right->intValue;
-                char* literal = malloc(20);
-                sprintf(literal, "%d", result);
-                return literal;
-            }
-            char* left = generateExpr(node->left);
-            char* right = generateExpr(node->right);
-            char* result = newTemp();
-            printf("ADD %s %s %s\n", left, right, result);
-            return result;
-        }
+        // Las operaciones con constantes ya fueron plegadas (constfold.c)
+        case NODE_ADD:
+            return generateBinary(node, IR_ADD);
         
-        case NODE_SUB: {
-            if (isConstant(node->left) && isConstant(node->right)) {
-                int result = node->left->intValue - node->right->intValue;
-                char* literal = malloc(20);
-                sprintf(literal, "%d", result);
-                return literal;
-            }
-            char* left = generateExpr(node->left);
-            char* right = generateExpr(node->right);
-            char* result = newTemp();
-            printf("SUB %s %s %s\n", left, right, result);
-            return result;
-        }
+        case NODE_SUB:
+            return generateBinary(node, IR_SUB);
         
-        case NODE_MUL: {
-            if (isConstant(node->left) && isConstant(node->right)) {
-                int result = node->left->intValue * node->right->intValue;
-                char* literal = malloc(20);
-                sprintf(literal, "%d", result);
-                return literal;
-            }
-            char* left = generateExpr(node->left);
-            char* right = generateExpr(node->right);
-            char* result = newTemp();
-            printf("MUL %s %s %s\n", left, right, result);
-            return result;
-        }
+        case NODE_MUL:
+            return generateBinary(node, IR_MUL);
         
-        case NODE_DIV: {
-            char* left = generateExpr(node->left);
-            char* right = generateExpr(node->right);
-            char* result = newTemp();
-            printf("DIV %s %s %s\n", left, right, result);
-            return result;
-        }
+        case NODE_DIV:
+            return generateBinary(node, IR_DIV);
         
-        case NODE_MOD: {
-            char* left = generateExpr(node->left);
-            char* right = generateExpr(node->right);
-            char* result = newTemp();
-            printf("MOD %s %s %s\n", left, right, result);
-            return result;
-        }
+        case NODE_MOD:
+            return generateBinary(node, IR_MOD);
         
-        case NODE_EQ: {
-            char* left = generateExpr(node->left);
-            char* right = generateExpr(node->right);
-            char* result = newTemp();
-            printf("EQ %s %s %s\n", left, right, result);
-            return result;
-        }
+        case NODE_EQ:
+            return generateBinary(node, IR_EQ);
         
-        case NODE_NEQ: {
-            char* left = generateExpr(node->left);
-            char* right = generateExpr(node->right);
-            char* result = newTemp();
-            printf("NEQ %s %s %s\n", left, right, result);
-            return result;
-        }
+        case NODE_NEQ:
+            return generateBinary(node, IR_NEQ);
         
-        case NODE_LT: {
-            char* left = generateExpr(node->left);
-            char* right = generateExpr(node->right);
-            char* result = newTemp();
-            printf("LT %s %s %s\n", left, right, result);
-            return result;
-        }
+        case NODE_LT:
+            return generateBinary(node, IR_LT);
         
-        case NODE_GT: {
-            char* left = generateExpr(node->left);
-            char* right = generateExpr(node->right);
-            char* result = newTemp();
-            printf("GT %s %s %s\n", left, right, result);
-            return result;
-        }
+        case NODE_GT:
+            return generateBinary(node, IR_GT);
         
-        case NODE_LTE: {
-            char* left = generateExpr(node->left);
-            char* right = generateExpr(node->right);
-            char* result = newTemp();
-            printf("LTE %s %s %s\n", left, right, result);
-            return result;
-        }
+        case NODE_LTE:
+            return generateBinary(node, IR_LTE);
         
-        case NODE_GTE: {
-            char* left = generateExpr(node->left);
-            char* right = generateExpr(node->right);
-            char* result = newTemp();
-            printf("GTE %s %s %s\n", left, right, result);
-            return result;
-        }
+        case NODE_GTE:
+            return generateBinary(node, IR_GTE);
         
-        case NODE_AND: {
-            char* left = generateExpr(node->left);
-            char* right = generateExpr(node->right);
-            char* result = newTemp();
-            printf("MUL %s %s %s\n", left, right, result);
-            return result;
-        }
+        case NODE_AND:
+        case NODE_OR:
+            return generateLogicalValue(node);
         
-        case NODE_OR: {
-            char* left = generateExpr(node->left);
-            char* right = generateExpr(node->right);
-            char* sum = newTemp();
-            char* result = newTemp();
-            printf("ADD %s %s %s\n", left, right, sum);
-            printf("GT %s 0 %s\n", sum, result);
-            return result;
-        }
+        case NODE_CALL:
+            return generateCall(node, 1);
         
         case NODE_NOT: {
-            char* operand = generateExpr(node->left);
-            char* result = newTemp();
-            printf("EQ %s 0 %s\n", operand, result);
+            Operand operand = generateExpr(AST_LEFT(node));
+            Operand result = newTemp();
+            irEmit(ir, IR_EQ, result, operand, opInt(0));
             return result;
         }
         
@@ -247,140 +490,169 @@ void generateCode(ASTNode* node) {
     
     switch (node->type) {
         case NODE_SEQ:
-            generateCode(node->left);
-            generateCode(node->right);
+            for (int i = 0; i < AST_STMT_COUNT(node); i++) {
+                generateCode(AST_STMT(node, i));
+            }
             break;
         
         case NODE_BLOCK:
-            generateCode(node->body);
+            generateCode(AST_BODY(node));
             break;
         
-        case NODE_ASSIGN:
-            declareVar(node->idName);
+        case NODE_ASSIGN: {
+            if (AST_INDEX(node)) {
+                // Asignación a elemento de arreglo
+                if (AST_INDEX(node)->type == NODE_INT) {
+                    Operand value = generateValue(AST_LEFT(node));
+                    Operand cell = opElem(node->idName, AST_INDEX(node)->intValue);
+                    irEmit(ir, IR_ASSIGN, cell, value, opNone());
+                } else {
+                    Operand index = generateExpr(AST_INDEX(node));
+                    Operand value = generateValue(AST_LEFT(node));
+                    irEmitTernary(ir, IR_STORE, value, opVar(node->idName), index);
+                }
+                break;
+            }
+            
+            char* dest = declareVar(node->idName);
             
             // OPTIMIZACIÓN: Asignaciones directas sin temporales
-            if (node->left->type == NODE_INT) {
-                printf("ASSIGN %d %s\n", node->left->intValue, node->idName);
-            } else if (node->left->type == NODE_FLOAT) {
-                printf("ASSIGN %.6f %s\n", node->left->floatValue, node->idName);
-            } else if (node->left->type == NODE_BOOL) {
-                printf("ASSIGN %d %s\n", node->left->intValue, node->idName);
-            } else if (node->left->type == NODE_ID) {
-                // Asignación directa variable a variable
-                printf("ASSIGN %s %s\n", node->left->idName, node->idName);
-            } else {
-                char* expr = generateExpr(node->left);
-                printf("ASSIGN %s %s\n", expr, node->idName);
-            }
+            Operand value = generateValue(AST_LEFT(node));
+            irEmit(ir, IR_ASSIGN, opVar(dest), value, opNone());
             break;
+        }
         
         case NODE_ARRAY_DECL: {
-            // Declarar cada elemento del arreglo
-            for (int i = 0; i < node->arraySize; i++) {
-                char varName[100];
-                sprintf(varName, "%s_%d", node->idName, i);
-                declareVar(varName);
-            }
+            // Un solo bloque contiguo: VAR arr[N]
+            irEmit(ir, IR_VAR, opVar(node->idName), opInt(node->arraySize), opNone());
             // Variable para length
             char lenName[100];
             sprintf(lenName, "%s_length", node->idName);
-            declareVar(lenName);
-            printf("ASSIGN %d %s\n", node->arraySize, lenName);
+            irEmit(ir, IR_ASSIGN, opVar(declareVar(intern(lenName))),
+                   opInt(node->arraySize), opNone());
             break;
         }
         
         case NODE_PIXEL: {
-            char* x = generateExpr(node->left);
-            char* y = generateExpr(node->right);
-            char* c = generateExpr(node->extra);
-            printf("PIXEL %s %s %s\n", x, y, c);
+            Operand x = generateExpr(AST_LEFT(node));
+            Operand y = generateExpr(AST_RIGHT(node));
+            Operand c = generateExpr(AST_EXTRA(node));
+            irEmitTernary(ir, IR_PIXEL, x, y, c);
             break;
         }
         
         case NODE_KEY:
-            declareVar(node->idName);
-            printf("KEY %d %s\n", node->intValue, node->idName);
+            irEmit(ir, IR_KEY, opVar(declareVar(node->idName)), opInt(node->intValue), opNone());
             break;
         
         case NODE_INPUT:
-            declareVar(node->idName);
-            printf("INPUT %s\n", node->idName);
+            irEmit(ir, IR_INPUT, opVar(declareVar(node->idName)), opNone(), opNone());
             break;
         
         case NODE_PRINT:
-            if (node->left->type == NODE_STRING) {
-                printf("PRINT \"%s\"\n", node->left->stringValue);
+            if (AST_LEFT(node)->type == NODE_STRING) {
+                irEmit(ir, IR_PRINT, opNone(), opString(AST_LEFT(node)->stringValue), opNone());
             } else {
-                char* expr = generateExpr(node->left);
-                printf("PRINT %s\n", expr);
+                Operand expr = generateExpr(AST_LEFT(node));
+                irEmit(ir, IR_PRINT, opNone(), expr, opNone());
             }
             break;
         
         case NODE_IF: {
-            char* cond = generateExpr(node->cond);
-            char* labelEnd = newLabel();
+            int labelEnd = newLabel();
             
-            printf("IFFALSE %s GOTO %s\n", cond, labelEnd);
-            generateCode(node->body);
-            printf("LABEL %s\n", labelEnd);
+            generateBranch(AST_COND(node), labelEnd, 0);
+            generateCode(AST_BODY(node));
+            irEmitJump(ir, IR_LABEL, opNone(), labelEnd);
             break;
         }
         
         case NODE_IF_ELSE: {
-            char* cond = generateExpr(node->cond);
-            char* labelElse = newLabel();
-            char* labelEnd = newLabel();
+            int labelElse = newLabel();
+            int labelEnd = newLabel();
             
-            printf("IFFALSE %s GOTO %s\n", cond, labelElse);
-            generateCode(node->body);
-            printf("GOTO %s\n", labelEnd);
-            printf("LABEL %s\n", labelElse);
-            generateCode(node->elseBody);
-            printf("LABEL %s\n", labelEnd);
+            generateBranch(AST_COND(node), labelElse, 0);
+            generateCode(AST_BODY(node));
+            irEmitJump(ir, IR_GOTO, opNone(), labelEnd);
+            irEmitJump(ir, IR_LABEL, opNone(), labelElse);
+            generateCode(AST_ELSE(node));
+            irEmitJump(ir, IR_LABEL, opNone(), labelEnd);
             break;
         }
         
+        // Bucles rotados: guarda + prueba al final, un solo salto por iteración
+        //     <cond falsa> GOTO Lend
+        //   LABEL Lbody
+        //     cuerpo
+        //     <cond verdadera> GOTO Lbody
+        //   LABEL Lend
         case NODE_WHILE: {
-            char* labelStart = newLabel();
-            char* labelEnd = newLabel();
+            int labelBody = newLabel();
+            int labelEnd = newLabel();
             
-            printf("LABEL %s\n", labelStart);
-            char* cond = generateExpr(node->cond);
-            printf("IFFALSE %s GOTO %s\n", cond, labelEnd);
-            generateCode(node->body);
-            printf("GOTO %s\n", labelStart);
-            printf("LABEL %s\n", labelEnd);
+            generateBranch(AST_COND(node), labelEnd, 0);
+            irEmitJump(ir, IR_LABEL, opNone(), labelBody);
+            int loopIndex = ir->loopCount;
+            int callsBefore = callCount;
+            irAddLoop(ir, labelBody, labelEnd, ++loopDepth);
+            generateCode(AST_BODY(node));
+            generateBranch(AST_COND(node), labelBody, 1);
+            irEmitJump(ir, IR_LABEL, opNone(), labelEnd);
+            if (callCount != callsBefore) ir->loops[loopIndex].hasCall = 1;
+            loopDepth--;
             break;
         }
         
         case NODE_FOR: {
-            generateCode(node->init);
+            generateCode(AST_INIT(node));
             
-            char* labelStart = newLabel();
-            char* labelEnd = newLabel();
+            int labelBody = newLabel();
+            int labelEnd = newLabel();
             
-            printf("LABEL %s\n", labelStart);
-            char* cond = generateExpr(node->cond);
-            printf("IFFALSE %s GOTO %s\n", cond, labelEnd);
+            generateBranch(AST_COND(node), labelEnd, 0);
+            irEmitJump(ir, IR_LABEL, opNone(), labelBody);
+            int loopIndex = ir->loopCount;
+            int callsBefore = callCount;
+            irAddLoop(ir, labelBody, labelEnd, ++loopDepth);
             
-            generateCode(node->body);
-            generateCode(node->increment);
+            generateCode(AST_BODY(node));
+            generateCode(AST_INCREMENT(node));
             
-            printf("GOTO %s\n", labelStart);
-            printf("LABEL %s\n", labelEnd);
+            generateBranch(AST_COND(node), labelBody, 1);
+            irEmitJump(ir, IR_LABEL, opNone(), labelEnd);
+            if (callCount != callsBefore) ir->loops[loopIndex].hasCall = 1;
+            loopDepth--;
             break;
         }
         
+        case NODE_FUNCTION:
+            // El cuerpo se genera al final, solo si alguien la llama
+            registerFunction(node);
+            break;
+        
+        case NODE_CALL:
+            generateCall(node, 0);
+            break;
+        
         case NODE_RETURN:
-            if (node->left) {
-                char* expr = generateExpr(node->left);
-                printf("RETURN %s\n", expr);
+            if (currentFunction >= 0) {
+                FunctionInfo* fn = &functions[currentFunction];
+                if (AST_LEFT(node)) {
+                    Operand value = generateValue(AST_LEFT(node));
+                    irEmit(ir, IR_ASSIGN, opVar(declareVar(fn->resultVar)), value, opNone());
+                }
+                irEmitJump(ir, IR_GOTO, opNone(), fn->exitLabel);
+                break;
+            }
+            if (AST_LEFT(node)) {
+                Operand expr = generateExpr(AST_LEFT(node));
+                irEmit(ir, IR_RETURN, opNone(), expr, opNone());
             } else {
-                printf("RETURN\n");
+                irEmit(ir, IR_RETURN, opNone(), opNone(), opNone());
             }
             break;
         
         default:
             break;
     }
-}
\ No newline at end of file
+}
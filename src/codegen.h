@@ -3,14 +3,16 @@
 #define CODEGEN_H
 
 #include "ast.h"
+#include "ir.h"
 
 // Contadores globales
 extern int labelCount;
 extern int tempCount;
 
 // Funciones principales
+IRProgram* generateIR(ASTNode* root);
 void generateCode(ASTNode* node);
-char* generateExpr(ASTNode* node);
+Operand generateExpr(ASTNode* node);
 
 // Generación de elementos específicos
 void generateDeclarations(ASTNode* node);
@@ -20,9 +22,9 @@ void generateArrayCode(ASTNode* node);
 void generateFunctionCode(ASTNode* node);
 
 // Helpers
-char* newTemp();
-char* newLabel();
-void declareVar(char* name);
+Operand newTemp();
+int newLabel();
+char* declareVar(char* name);
 
 // Información de generación
 int getLabelCount();
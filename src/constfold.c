@@ -0,0 +1,413 @@
+/* constfold.c - Plegado y propagación de constantes sobre el AST */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "constfold.h"
+
+/*
+ * Reglas de tipo (las mismas de computeType en semantic.c):
+ *   int/bool op int/bool -> int
+ *   si algún operando es float -> float
+ *   comparaciones y operadores lógicos -> bool (0 o 1)
+ *
+ * Una variable se propaga cuando tiene una sola asignación en todo el
+ * programa y esa asignación está en el nivel superior (fuera de bucles
+ * y condicionales) con un valor constante. Solo se reemplazan los usos
+ * que aparecen después de la declaración.
+ */
+
+typedef struct {
+    VarType type;
+    int intValue;
+    float floatValue;
+} ConstValue;
+
+// Información por variable
+typedef struct {
+    char* name;
+    int assignCount;
+    int known;
+    ConstValue value;
+} VarInfo;
+
+#define VARS_INITIAL_CAPACITY 256
+
+static VarInfo* vars = NULL;
+static int varCapacity = 0;
+static int varCount = 0;
+
+static FoldStats stats;
+
+/* ============================================================
+   TABLA DE VARIABLES
+   ============================================================ */
+
+// Los nombres están internados (intern): su número sirve de hash
+static unsigned int hashName(const char* name) {
+    return (unsigned int)internId(name);
+}
+
+static VarInfo* lookupVar(const char* name, int create);
+
+static void growVars() {
+    VarInfo* old = vars;
+    int oldCapacity = varCapacity;
+
+    varCapacity = varCapacity ? varCapacity * 2 : VARS_INITIAL_CAPACITY;
+    vars = calloc(varCapacity, sizeof(VarInfo));
+    varCount = 0;
+    for (int i = 0; i < oldCapacity; i++) {
+        if (old[i].name) {
+            VarInfo* v = lookupVar(old[i].name, 1);
+            *v = old[i];
+        }
+    }
+    free(old);
+}
+
+static VarInfo* lookupVar(const char* name, int create) {
+    if (create && (varCount + 1) * 4 > varCapacity * 3) {
+        growVars();
+    }
+    if (varCapacity == 0) return NULL;
+
+    unsigned int i = hashName(name) & (varCapacity - 1);
+    while (vars[i].name) {
+        if (vars[i].name == name) return &vars[i];
+        i = (i + 1) & (varCapacity - 1);
+    }
+    if (!create) return NULL;
+
+    vars[i].name = (char*)name;
+    vars[i].assignCount = 0;
+    vars[i].known = 0;
+    varCount++;
+    return &vars[i];
+}
+
+static void freeVars() {
+    free(vars);
+    vars = NULL;
+    varCapacity = 0;
+    varCount = 0;
+}
+
+// Cuenta cuántas veces se escribe cada variable en todo el programa
+static void countAssignments(ASTNode* node) {
+    if (!node) return;
+
+    switch (node->type) {
+        case NODE_ASSIGN:
+            if (!AST_INDEX(node)) lookupVar(node->idName, 1)->assignCount++;
+            break;
+        case NODE_KEY:
+        case NODE_INPUT:
+            lookupVar(node->idName, 1)->assignCount++;
+            break;
+        default:
+            break;
+    }
+
+    for (int k = 0; k < AST_KID_COUNT(node); k++) countAssignments(AST_KIDS(node)[k]);
+    countAssignments(node->next);
+}
+
+/* ============================================================
+   LITERALES
+   ============================================================ */
+
+static int isLiteral(ASTNode* node) {
+    return node && (node->type == NODE_INT ||
+                    node->type == NODE_FLOAT ||
+                    node->type == NODE_BOOL);
+}
+
+static ConstValue literalValue(ASTNode* node) {
+    ConstValue v;
+    if (node->type == NODE_FLOAT) {
+        v.type = TYPE_FLOAT_T;
+        v.floatValue = node->floatValue;
+        v.intValue = (int)node->floatValue;
+    } else {
+        v.type = TYPE_INT_T;
+        v.intValue = node->intValue;
+        v.floatValue = (float)node->intValue;
+    }
+    return v;
+}
+
+static int isTrue(ConstValue v) {
+    return v.type == TYPE_FLOAT_T ? v.floatValue != 0.0f : v.intValue != 0;
+}
+
+// Convierte el nodo (y descarta sus hijos) en un literal
+static void replaceWithLiteral(ASTNode* node, ConstValue v, VarType nodeType) {
+    freeAST(AST_LEFT(node));
+    freeAST(AST_RIGHT(node));
+    AST_LEFT(node) = NULL;
+    AST_RIGHT(node) = NULL;
+    node->idName = NULL;
+
+    if (v.type == TYPE_FLOAT_T) {
+        node->type = NODE_FLOAT;
+        node->floatValue = v.floatValue;
+        node->varType = TYPE_FLOAT_T;
+    } else {
+        node->type = NODE_INT;
+        node->intValue = v.intValue;
+        node->varType = nodeType;
+    }
+}
+
+// Reemplaza el nodo por uno de sus hijos (identidades x+0, x*1, ...)
+static void replaceWithChild(ASTNode* node, ASTNode* keep) {
+    ASTNode* other = (keep == AST_LEFT(node)) ? AST_RIGHT(node) : AST_LEFT(node);
+    freeAST(other);
+    *node = *keep;
+    freeNode(keep);
+}
+
+/* ============================================================
+   PLEGADO
+   ============================================================ */
+
+// Guarda el resultado entero; falla si no cabe en un int y la operación
+// es entera (el desbordamiento se deja para la ejecución, como con -O0)
+static int storeInt(long long value, int isFloat, ConstValue* out) {
+    if (!isFloat && (value < INT_MIN || value > INT_MAX)) return 0;
+    out->intValue = (int)value;
+    return 1;
+}
+
+// Calcula op(a, b); retorna 0 si no se puede plegar (p. ej. división por 0)
+static int evalBinary(NodeType op, ConstValue a, ConstValue b, ConstValue* out) {
+    int isFloat = (a.type == TYPE_FLOAT_T || b.type == TYPE_FLOAT_T);
+    out->type = isFloat ? TYPE_FLOAT_T : TYPE_INT_T;
+
+    switch (op) {
+        case NODE_ADD:
+            out->floatValue = a.floatValue + b.floatValue;
+            return storeInt((long long)a.intValue + b.intValue, isFloat, out);
+        case NODE_SUB:
+            out->floatValue = a.floatValue - b.floatValue;
+            return storeInt((long long)a.intValue - b.intValue, isFloat, out);
+        case NODE_MUL:
+            out->floatValue = a.floatValue * b.floatValue;
+            return storeInt((long long)a.intValue * b.intValue, isFloat, out);
+        case NODE_DIV:
+            if (isFloat) {
+                if (b.floatValue == 0.0f) return 0;
+                out->floatValue = a.floatValue / b.floatValue;
+            } else {
+                // INT_MIN / -1 no cabe en un int
+                if (b.intValue == 0 || (a.intValue == INT_MIN && b.intValue == -1)) return 0;
+                out->intValue = a.intValue / b.intValue;
+            }
+            return 1;
+        case NODE_MOD:
+            if (isFloat || b.intValue == 0) return 0;
+            if (a.intValue == INT_MIN && b.intValue == -1) return 0;
+            out->intValue = a.intValue % b.intValue;
+            return 1;
+        default:
+            break;
+    }
+
+    // Comparaciones y lógicos: resultado bool
+    int r;
+    switch (op) {
+        case NODE_LT:  r = isFloat ? a.floatValue <  b.floatValue : a.intValue <  b.intValue; break;
+        case NODE_GT:  r = isFloat ? a.floatValue >  b.floatValue : a.intValue >  b.intValue; break;
+        case NODE_LTE: r = isFloat ? a.floatValue <= b.floatValue : a.intValue <= b.intValue; break;
+        case NODE_GTE: r = isFloat ? a.floatValue >= b.floatValue : a.intValue >= b.intValue; break;
+        case NODE_EQ:  r = isFloat ? a.floatValue == b.floatValue : a.intValue == b.intValue; break;
+        case NODE_NEQ: r = isFloat ? a.floatValue != b.floatValue : a.intValue != b.intValue; break;
+        case NODE_AND: r = isTrue(a) && isTrue(b); break;
+        case NODE_OR:  r = isTrue(a) || isTrue(b); break;
+        default:
+            return 0;
+    }
+    out->type = TYPE_INT_T;
+    out->intValue = r;
+    out->floatValue = (float)r;
+    return 1;
+}
+
+static int isIntLiteral(ASTNode* node, int value) {
+    return node && (node->type == NODE_INT || node->type == NODE_BOOL) &&
+           node->intValue == value;
+}
+
+// Pliega una expresión de abajo hacia arriba
+static void foldExpr(ASTNode* node) {
+    if (!node) return;
+
+    switch (node->type) {
+        case NODE_ID: {
+            VarInfo* v = lookupVar(node->idName, 0);
+            if (v && v->known) {
+                replaceWithLiteral(node, v->value, v->value.type);
+                stats.propagated++;
+            }
+            return;
+        }
+
+        case NODE_ARRAY_ACCESS:
+            foldExpr(AST_INDEX(node));
+            return;
+
+        case NODE_CALL:
+            for (ASTNode* arg = AST_ARGS(node); arg; arg = arg->next) {
+                // replaceWithChild copia el nodo completo, incluido next
+                ASTNode* next = arg->next;
+                foldExpr(arg);
+                arg->next = next;
+            }
+            return;
+
+        case NODE_NOT:
+            foldExpr(AST_LEFT(node));
+            if (isLiteral(AST_LEFT(node))) {
+                ConstValue v;
+                v.type = TYPE_INT_T;
+                v.intValue = !isTrue(literalValue(AST_LEFT(node)));
+                replaceWithLiteral(node, v, TYPE_BOOL_T);
+                stats.folded++;
+            }
+            return;
+
+        case NODE_ADD:
+        case NODE_SUB:
+        case NODE_MUL:
+        case NODE_DIV:
+        case NODE_MOD:
+        case NODE_LT:
+        case NODE_GT:
+        case NODE_LTE:
+        case NODE_GTE:
+        case NODE_EQ:
+        case NODE_NEQ:
+        case NODE_AND:
+        case NODE_OR: {
+            foldExpr(AST_LEFT(node));
+            foldExpr(AST_RIGHT(node));
+
+            if (isLiteral(AST_LEFT(node)) && isLiteral(AST_RIGHT(node))) {
+                ConstValue result;
+                if (evalBinary(node->type, literalValue(AST_LEFT(node)),
+                               literalValue(AST_RIGHT(node)), &result)) {
+                    VarType t = (node->type >= NODE_LT) ? TYPE_BOOL_T : result.type;
+                    replaceWithLiteral(node, result, t);
+                    stats.folded++;
+                }
+                return;
+            }
+
+            // Identidades aritméticas: x+0, 0+x, x-0, x*1, 1*x, x/1
+            if ((node->type == NODE_ADD && isIntLiteral(AST_RIGHT(node), 0)) ||
+                (node->type == NODE_SUB && isIntLiteral(AST_RIGHT(node), 0)) ||
+                (node->type == NODE_MUL && isIntLiteral(AST_RIGHT(node), 1)) ||
+                (node->type == NODE_DIV && isIntLiteral(AST_RIGHT(node), 1))) {
+                replaceWithChild(node, AST_LEFT(node));
+                stats.folded++;
+            } else if ((node->type == NODE_ADD && isIntLiteral(AST_LEFT(node), 0)) ||
+                       (node->type == NODE_MUL && isIntLiteral(AST_LEFT(node), 1))) {
+                replaceWithChild(node, AST_RIGHT(node));
+                stats.folded++;
+            }
+            return;
+        }
+
+        default:
+            return;
+    }
+}
+
+// Recorre las sentencias en orden de ejecución
+static void foldStatements(ASTNode* node, int topLevel) {
+    if (!node) return;
+
+    switch (node->type) {
+        case NODE_SEQ:
+            for (int i = 0; i < AST_STMT_COUNT(node); i++) {
+                foldStatements(AST_STMT(node, i), topLevel);
+            }
+            break;
+
+        case NODE_BLOCK:
+            foldStatements(AST_BODY(node), 0);
+            break;
+
+        case NODE_ASSIGN:
+            foldExpr(AST_INDEX(node));
+            foldExpr(AST_LEFT(node));
+            if (topLevel && !AST_INDEX(node) && isLiteral(AST_LEFT(node))) {
+                VarInfo* v = lookupVar(node->idName, 0);
+                if (v && v->assignCount == 1) {
+                    v->known = 1;
+                    v->value = literalValue(AST_LEFT(node));
+                    // El valor toma el tipo declarado de la variable
+                    if (node->varType == TYPE_FLOAT_T && v->value.type != TYPE_FLOAT_T) {
+                        v->value.type = TYPE_FLOAT_T;
+                    } else if (node->varType != TYPE_FLOAT_T && v->value.type == TYPE_FLOAT_T) {
+                        v->known = 0;
+                    }
+                }
+            }
+            break;
+
+        case NODE_PIXEL:
+            foldExpr(AST_LEFT(node));
+            foldExpr(AST_RIGHT(node));
+            foldExpr(AST_EXTRA(node));
+            break;
+
+        case NODE_PRINT:
+        case NODE_RETURN:
+            foldExpr(AST_LEFT(node));
+            break;
+
+        case NODE_IF:
+        case NODE_IF_ELSE:
+            foldExpr(AST_COND(node));
+            foldStatements(AST_BODY(node), 0);
+            foldStatements(AST_ELSE(node), 0);
+            break;
+
+        case NODE_WHILE:
+            foldExpr(AST_COND(node));
+            foldStatements(AST_BODY(node), 0);
+            break;
+
+        case NODE_CALL:
+            foldExpr(node);
+            break;
+
+        // El cuerpo solo se ejecuta al llamarla, siempre después de su definición
+        case NODE_FUNCTION:
+            foldStatements(AST_BODY(node), 0);
+            break;
+
+        case NODE_FOR:
+            foldStatements(AST_INIT(node), 0);
+            foldExpr(AST_COND(node));
+            foldStatements(AST_BODY(node), 0);
+            foldStatements(AST_INCREMENT(node), 0);
+            break;
+
+        default:
+            break;
+    }
+}
+
+FoldStats foldConstants(ASTNode* root) {
+    stats.folded = 0;
+    stats.propagated = 0;
+
+    countAssignments(root);
+    foldStatements(root, 1);
+    freeVars();
+
+    return stats;
+}
@@ -0,0 +1,16 @@
+/* constfold.h - Plegado y propagación de constantes sobre el AST */
+#ifndef CONSTFOLD_H
+#define CONSTFOLD_H
+
+#include "ast.h"
+
+// Resultado del plegado
+typedef struct {
+    int folded;         // Operaciones reemplazadas por su valor
+    int propagated;     // Usos de variables constantes reemplazados
+} FoldStats;
+
+// Pliega expresiones constantes y propaga variables de valor fijo
+FoldStats foldConstants(ASTNode* root);
+
+#endif
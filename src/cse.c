@@ -0,0 +1,350 @@
+/* cse.c - Numeración de valores y eliminación de subexpresiones comunes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cse.h"
+#include "cfg.h"
+
+/*
+ * Numeración de valores sobre el árbol de dominadores: cada versión SSA
+ * recibe un número de valor (VN) y cada operación pura se identifica por
+ * (op, vn(a), vn(b)). Si la misma clave ya se calculó en un bloque que
+ * domina al actual y el resultado sigue guardado en alguna variable o
+ * temporal, la operación se reemplaza por una copia.
+ *
+ * La tabla de expresiones tiene alcance: lo insertado en un bloque se
+ * retira al salir de su subárbol. Un operando "guarda" todavía un VN si
+ * la versión actual de su nombre es la que lo recibió. Con SSA podada eso
+ * vale por todos los caminos si el nombre se escribe en un solo punto, si
+ * está vivo a la entrada del bloque o si no hay ninguna unión entre la
+ * definición y el bloque: en una unión donde el nombre está muerto falta
+ * el phi que lo cambiaría.
+ *
+ * Las celdas de arreglo (arr[k] y LOAD) reciben siempre un valor nuevo;
+ * KEY e INPUT también, porque cada lectura puede dar algo distinto.
+ */
+
+// Claves para literales dentro de la misma tabla de expresiones
+#define KEY_INT   (-1)
+#define KEY_FLOAT (-2)
+
+typedef struct {
+    int op;
+    int a;
+    int b;
+    int vn;
+    int next;           // Siguiente entrada de la misma cubeta
+} ValueEntry;
+
+// Quién guarda un VN: el operando y la versión con que lo recibió
+typedef struct {
+    Operand operand;
+    int version;
+    int block;          // Bloque de la definición (-1: valor de entrada)
+} Holder;
+
+typedef struct {
+    SSAForm* ssa;
+    int block;              // Bloque que se está numerando
+    int* joinAbove;         // Unión (2+ predecesores) más cercana hacia la raíz
+    char* singleDef;        // 1 si el nombre se escribe en una sola instrucción
+
+    int* buckets;
+    int bucketMask;
+    ValueEntry* entries;    // Pila: se descarta al salir de cada bloque
+    int entryCount;
+    int entryCapacity;
+
+    int* versionVN;         // VN de cada versión (-1 si aún no tiene)
+    int* current;           // Versión actual de cada nombre
+    int* logName;           // Registro para deshacer current
+    int* logOld;
+    int logTop;
+
+    Holder* holder;
+    int vnCount;
+    int vnCapacity;
+} ValueState;
+
+/* ============================================================
+   NÚMEROS DE VALOR
+   ============================================================ */
+
+static int newValue(ValueState* st) {
+    if (st->vnCount == st->vnCapacity) {
+        st->vnCapacity *= 2;
+        st->holder = realloc(st->holder, sizeof(Holder) * st->vnCapacity);
+    }
+    st->holder[st->vnCount].operand = opNone();
+    st->holder[st->vnCount].version = -1;
+    st->holder[st->vnCount].block = -1;
+    return st->vnCount++;
+}
+
+static unsigned int hashKey(int op, int a, int b) {
+    unsigned int h = (unsigned int)op * 31u + (unsigned int)a;
+    h = h * 1000003u + (unsigned int)b;
+    return h ^ (h >> 15);
+}
+
+// Busca (op, a, b); si no existe y create, le asigna un VN nuevo.
+// Retorna -1 si no existe y no se pidió crear.
+static int lookupValue(ValueState* st, int op, int a, int b, int create) {
+    unsigned int h = hashKey(op, a, b) & st->bucketMask;
+    for (int e = st->buckets[h]; e >= 0; e = st->entries[e].next) {
+        ValueEntry* entry = &st->entries[e];
+        if (entry->op == op && entry->a == a && entry->b == b) return entry->vn;
+    }
+    if (!create) return -1;
+
+    if (st->entryCount == st->entryCapacity) {
+        st->entryCapacity *= 2;
+        st->entries = realloc(st->entries, sizeof(ValueEntry) * st->entryCapacity);
+    }
+    ValueEntry* entry = &st->entries[st->entryCount];
+    entry->op = op;
+    entry->a = a;
+    entry->b = b;
+    entry->vn = newValue(st);
+    entry->next = st->buckets[h];
+    st->buckets[h] = st->entryCount++;
+    return entry->vn;
+}
+
+// Retira las entradas insertadas después de mark (en orden inverso)
+static void popEntries(ValueState* st, int mark) {
+    while (st->entryCount > mark) {
+        ValueEntry* entry = &st->entries[--st->entryCount];
+        unsigned int h = hashKey(entry->op, entry->a, entry->b) & st->bucketMask;
+        st->buckets[h] = entry->next;
+    }
+}
+
+// 1 si el nombre del holder sigue en la versión que recibió el VN
+static int holdsValue(ValueState* st, int vn) {
+    Holder* h = &st->holder[vn];
+    if (h->version < 0) return 0;
+    int name = st->ssa->versionName[h->version];
+    if (st->current[name] != h->version) return 0;
+    if (h->block >= 0 && st->singleDef[name]) return 1;
+
+    // Sin uniones entre la definición y este bloque no pudo faltar un phi
+    int join = st->joinAbove[st->block];
+    if (join < 0) return 1;
+    if (h->block >= 0 && (join == h->block || !cfgDominates(st->ssa->cfg, h->block, join))) {
+        return 1;
+    }
+    return ssaLiveIn(st->ssa, st->block, name);
+}
+
+static void setCurrent(ValueState* st, int name, int version) {
+    st->logName[st->logTop] = name;
+    st->logOld[st->logTop++] = st->current[name];
+    st->current[name] = version;
+}
+
+// Registra que la versión recibe el valor vn, guardado en o
+static void defineVersion(ValueState* st, Operand* o, int version, int vn) {
+    st->versionVN[version] = vn;
+    setCurrent(st, st->ssa->versionName[version], version);
+    if (!holdsValue(st, vn)) {
+        st->holder[vn].operand = *o;
+        st->holder[vn].version = version;
+        st->holder[vn].block = st->block;
+    }
+}
+
+// VN del valor que tiene el operando en la ranura dada
+static int operandValue(ValueState* st, Operand* o, int slot) {
+    switch (o->kind) {
+        case OPD_INT:
+            return lookupValue(st, KEY_INT, o->num, 0, 1);
+        case OPD_FLOAT: {
+            int bits;
+            memcpy(&bits, &o->fnum, sizeof(int));
+            return lookupValue(st, KEY_FLOAT, bits, 0, 1);
+        }
+        case OPD_VAR:
+        case OPD_TEMP: {
+            int version = st->ssa->opVersion[slot];
+            if (st->versionVN[version] < 0) {
+                // Valor de entrada: se numera la primera vez que se lee
+                int vn = newValue(st);
+                st->versionVN[version] = vn;
+                st->holder[vn].operand = *o;
+                st->holder[vn].version = version;
+            }
+            return st->versionVN[version];
+        }
+        default:
+            return newValue(st);
+    }
+}
+
+/* ============================================================
+   RECORRIDO
+   ============================================================ */
+
+static int isCommutative(IROpcode op) {
+    return op == IR_ADD || op == IR_MUL || op == IR_EQ || op == IR_NEQ;
+}
+
+static int numberInstr(ValueState* st, IRInstr* ins, int index) {
+    int* opVersion = &st->ssa->opVersion[index * 4];
+
+    // Un temporal leído puede cambiarse por otro que ya guarda su valor
+    Operand* uses[3];
+    int n = irUses(ins, uses);
+    for (int k = 0; k < n; k++) {
+        if (uses[k]->kind != OPD_TEMP) continue;
+        int slot = ssaSlot(ins, uses[k]);
+        int vn = operandValue(st, uses[k], index * 4 + slot);
+        Holder* h = &st->holder[vn];
+        if (h->operand.kind == OPD_TEMP && h->operand.num != uses[k]->num &&
+            holdsValue(st, vn)) {
+            *uses[k] = h->operand;
+            opVersion[slot] = h->version;
+        }
+    }
+
+    Operand* def = irDef(ins);
+    int defVersion = (def && (def->kind == OPD_VAR || def->kind == OPD_TEMP))
+                     ? opVersion[0] : -1;
+
+    if (irIsBinary(ins->op)) {
+        int a = operandValue(st, &ins->a, index * 4 + 1);
+        int b = operandValue(st, &ins->b, index * 4 + 2);
+        if (isCommutative(ins->op) && a > b) {
+            int t = a;
+            a = b;
+            b = t;
+        }
+        int vn = lookupValue(st, ins->op, a, b, 0);
+        int found = vn >= 0 && holdsValue(st, vn);
+        if (found) {
+            // Ya calculado: copiar el resultado guardado
+            ins->op = IR_ASSIGN;
+            ins->a = st->holder[vn].operand;
+            ins->b = opNone();
+            opVersion[1] = st->holder[vn].version;
+            opVersion[2] = -1;
+        } else if (vn < 0) {
+            vn = lookupValue(st, ins->op, a, b, 1);
+        }
+        if (defVersion >= 0) defineVersion(st, def, defVersion, vn);
+        return found;
+    }
+
+    if (defVersion < 0) return 0;
+    if (ins->op == IR_ASSIGN) {
+        defineVersion(st, def, defVersion, operandValue(st, &ins->a, index * 4 + 1));
+    } else {
+        // LOAD, KEY, INPUT: valor desconocido
+        defineVersion(st, def, defVersion, newValue(st));
+    }
+    return 0;
+}
+
+int eliminateCommonSubexpressions(IRProgram* prog) {
+    if (prog->count == 0) return 0;
+
+    CFG* cfg = cfgBuild(prog);
+    SSAForm* ssa = ssaBuild(cfg);
+
+    ValueState st;
+    st.ssa = ssa;
+    int bucketCount = 64;
+    while (bucketCount < prog->count * 2) bucketCount *= 2;
+    st.buckets = malloc(sizeof(int) * bucketCount);
+    for (int h = 0; h < bucketCount; h++) st.buckets[h] = -1;
+    st.bucketMask = bucketCount - 1;
+    st.entryCapacity = 256;
+    st.entryCount = 0;
+    st.entries = malloc(sizeof(ValueEntry) * st.entryCapacity);
+
+    st.versionVN = malloc(sizeof(int) * (ssa->versionCount + 1));
+    for (int v = 0; v < ssa->versionCount; v++) st.versionVN[v] = -1;
+    st.current = malloc(sizeof(int) * (ssa->nameCount + 1));
+    for (int x = 0; x < ssa->nameCount; x++) st.current[x] = ssa->entryVersion[x];
+    st.logName = malloc(sizeof(int) * (ssa->versionCount + 1));
+    st.logOld = malloc(sizeof(int) * (ssa->versionCount + 1));
+    st.logTop = 0;
+
+    int* defCount = calloc(ssa->nameCount + 1, sizeof(int));
+    for (int v = 0; v < ssa->versionCount; v++) {
+        if (ssa->versionDef[v] >= 0) defCount[ssa->versionName[v]]++;
+    }
+    st.singleDef = malloc(ssa->nameCount + 1);
+    for (int x = 0; x < ssa->nameCount; x++) st.singleDef[x] = defCount[x] == 1;
+    free(defCount);
+
+    st.vnCapacity = 256;
+    st.vnCount = 0;
+    st.holder = malloc(sizeof(Holder) * st.vnCapacity);
+
+    // Preorden del árbol de dominadores; al salir de un bloque se
+    // deshacen sus entradas y versiones
+    int n = cfg->blockCount;
+    int* stack = malloc(sizeof(int) * (2 * n + 2));
+    int* entryMark = malloc(sizeof(int) * (n + 1));
+    int* logMark = malloc(sizeof(int) * (n + 1));
+    st.joinAbove = malloc(sizeof(int) * (n + 1));
+    int top = 0;
+    int replaced = 0;
+    if (cfg->reachableCount > 0) stack[top++] = cfg->rpo[0];
+
+    while (top > 0) {
+        int item = stack[--top];
+        if (item < 0) {
+            int b = -item - 1;
+            popEntries(&st, entryMark[b]);
+            while (st.logTop > logMark[b]) {
+                st.logTop--;
+                st.current[st.logName[st.logTop]] = st.logOld[st.logTop];
+            }
+            continue;
+        }
+
+        int b = item;
+        entryMark[b] = st.entryCount;
+        logMark[b] = st.logTop;
+        st.block = b;
+        if (cfg->predStart[b + 1] - cfg->predStart[b] >= 2) {
+            st.joinAbove[b] = b;
+        } else {
+            st.joinAbove[b] = cfg->idom[b] == b ? -1 : st.joinAbove[cfg->idom[b]];
+        }
+
+        // Un phi no se identifica con nada: valor nuevo
+        for (int p = ssa->phiStart[b]; p < ssa->phiStart[b + 1]; p++) {
+            SSAPhi* phi = &ssa->phis[p];
+            int vn = newValue(&st);
+            st.versionVN[phi->dst] = vn;
+            setCurrent(&st, phi->name, phi->dst);
+        }
+        for (int i = prog->blocks[b].start; i < prog->blocks[b].end; i++) {
+            replaced += numberInstr(&st, &prog->code[i], i);
+        }
+
+        stack[top++] = -b - 1;
+        for (int c = cfg->childStart[b + 1] - 1; c >= cfg->childStart[b]; c--) {
+            stack[top++] = cfg->children[c];
+        }
+    }
+
+    free(stack);
+    free(entryMark);
+    free(logMark);
+    free(st.joinAbove);
+    free(st.singleDef);
+    free(st.buckets);
+    free(st.entries);
+    free(st.versionVN);
+    free(st.current);
+    free(st.logName);
+    free(st.logOld);
+    free(st.holder);
+    ssaFree(ssa);
+    cfgFree(cfg);
+    return replaced;
+}
@@ -0,0 +1,11 @@
+/* cse.h - Numeración de valores y eliminación de subexpresiones comunes */
+#ifndef CSE_H
+#define CSE_H
+
+#include "ir.h"
+
+// Reemplaza operaciones repetidas por copias del resultado ya calculado.
+// Retorna la cantidad de operaciones eliminadas.
+int eliminateCommonSubexpressions(IRProgram* prog);
+
+#endif
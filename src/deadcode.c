@@ -0,0 +1,179 @@
+/* deadcode.c - Eliminación de código muerto sobre el código intermedio */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "deadcode.h"
+#include "cfg.h"
+
+/*
+ * Tres limpiezas, en este orden y una sola vez cada una:
+ *
+ *   1. Bloques inalcanzables desde el inicio (IF con condición falsa,
+ *      código después de RETURN o de un GOTO).
+ *   2. Escrituras muertas: ASSIGN, LOAD y aritmética cuyo destino (una
+ *      variable escalar o un temporal) no se lee antes de reescribirse.
+ *      KEY e INPUT se conservan porque consumen entrada.
+ *   3. Declaraciones VAR de nombres que ya nadie usa.
+ *
+ * Las escrituras muertas se buscan sobre la forma SSA (cfg.c): una
+ * versión sin lecturas está muerta, y al quitar su escritura se descuentan
+ * las lecturas de sus operandos, que pueden quedar muertos a su vez. Una
+ * lista de trabajo encadena esas bajas sin recalcular la vida del programa.
+ *
+ * Las celdas de arreglo nunca se consideran muertas. Las declaraciones
+ * VAR de bloques inalcanzables se conservan: la variable puede usarse
+ * más adelante en código que sí se ejecuta.
+ */
+
+/* ============================================================
+   BLOQUES INALCANZABLES
+   ============================================================ */
+
+static int removeUnreachable(IRProgram* prog) {
+    CFG* cfg = cfgBuild(prog);
+    int removed = 0;
+
+    for (int b = 0; b < cfg->blockCount; b++) {
+        if (cfg->rpoIndex[b] >= 0) continue;
+        for (int i = prog->blocks[b].start; i < prog->blocks[b].end; i++) {
+            IRInstr* ins = &prog->code[i];
+            if (ins->op == IR_VAR || ins->op == IR_NOP) continue;
+            if (ins->op != IR_LABEL && ins->op != IR_COMMENT) removed++;
+            ins->op = IR_NOP;
+        }
+    }
+
+    cfgFree(cfg);
+    return removed;
+}
+
+/* ============================================================
+   ESCRITURAS MUERTAS
+   ============================================================ */
+
+// Escrituras que se pueden quitar si el destino está muerto
+static int isRemovable(IRInstr* ins) {
+    if (ins->dst.kind != OPD_VAR && ins->dst.kind != OPD_TEMP) return 0;
+    return ins->op == IR_ASSIGN || ins->op == IR_LOAD || irIsBinary(ins->op);
+}
+
+static int removeDeadStores(IRProgram* prog) {
+    CFG* cfg = cfgBuild(prog);
+    SSAForm* ssa = ssaBuild(cfg);
+    int versions = ssa->versionCount;
+
+    // Lecturas de cada versión: instrucciones y argumentos de phis
+    int* useCount = malloc(sizeof(int) * (versions + 1));
+    int* phiOf = malloc(sizeof(int) * (versions + 1));
+    for (int v = 0; v < versions; v++) {
+        useCount[v] = ssa->useStart[v + 1] - ssa->useStart[v];
+        phiOf[v] = -1;
+    }
+    for (int p = 0; p < ssa->phiCount; p++) {
+        SSAPhi* phi = &ssa->phis[p];
+        int arity = cfg->predStart[phi->block + 1] - cfg->predStart[phi->block];
+        phiOf[phi->dst] = p;
+        for (int a = 0; a < arity; a++) {
+            if (phi->args[a] >= 0) useCount[phi->args[a]]++;
+        }
+    }
+
+    // Lista de trabajo: versiones sin lecturas
+    int* work = malloc(sizeof(int) * (versions + 1));
+    int top = 0;
+    for (int v = 0; v < versions; v++) {
+        if (useCount[v] == 0) work[top++] = v;
+    }
+
+    int removed = 0;
+    while (top > 0) {
+        int v = work[--top];
+        int def = ssa->versionDef[v];
+        int released[3];
+        int count = 0;
+
+        if (def >= 0) {
+            IRInstr* ins = &prog->code[def];
+            if (!isRemovable(ins)) continue;
+            for (int slot = 1; slot < 4; slot++) {
+                int used = ssa->opVersion[def * 4 + slot];
+                if (used >= 0) released[count++] = used;
+            }
+            ins->op = IR_NOP;
+            removed++;
+        } else if (phiOf[v] >= 0) {
+            // Un phi muerto libera sus argumentos
+            SSAPhi* phi = &ssa->phis[phiOf[v]];
+            int arity = cfg->predStart[phi->block + 1] - cfg->predStart[phi->block];
+            for (int a = 0; a < arity; a++) {
+                int arg = phi->args[a];
+                if (arg >= 0 && --useCount[arg] == 0) work[top++] = arg;
+            }
+        }
+        for (int k = 0; k < count; k++) {
+            if (--useCount[released[k]] == 0) work[top++] = released[k];
+        }
+    }
+
+    free(useCount);
+    free(phiOf);
+    free(work);
+    ssaFree(ssa);
+    cfgFree(cfg);
+    return removed;
+}
+
+/* ============================================================
+   DECLARACIONES SIN USO
+   ============================================================ */
+
+static int removeUnusedVars(IRProgram* prog) {
+    int varCount = irNumberVariables(prog);
+    int tempLimit = irMaxTemp(prog);
+    char* usedVar = calloc(varCount + 1, 1);
+    char* usedTemp = calloc(tempLimit + 1, 1);
+
+    for (int i = 0; i < prog->count; i++) {
+        IRInstr* ins = &prog->code[i];
+        if (ins->op == IR_VAR || ins->op == IR_NOP) continue;
+        Operand* ops[4] = { &ins->dst, &ins->a, &ins->b, &ins->c };
+        for (int k = 0; k < 4; k++) {
+            if (ops[k]->kind == OPD_VAR || ops[k]->kind == OPD_ELEM) {
+                usedVar[ops[k]->id] = 1;
+            } else if (ops[k]->kind == OPD_TEMP) {
+                usedTemp[ops[k]->num] = 1;
+            }
+        }
+    }
+
+    int removed = 0;
+    for (int i = 0; i < prog->count; i++) {
+        IRInstr* ins = &prog->code[i];
+        if (ins->op != IR_VAR) continue;
+        int used = ins->dst.kind == OPD_TEMP ? usedTemp[ins->dst.num]
+                                             : usedVar[ins->dst.id];
+        if (!used) {
+            ins->op = IR_NOP;
+            removed++;
+        }
+    }
+
+    free(usedVar);
+    free(usedTemp);
+    return removed;
+}
+
+DeadCodeStats eliminateDeadCode(IRProgram* prog) {
+    DeadCodeStats stats = { 0, 0, 0 };
+
+    // Quitar escrituras no cambia los saltos: basta una vuelta
+    stats.unreachable = removeUnreachable(prog);
+    irCompact(prog);
+    stats.deadStores = removeDeadStores(prog);
+    irCompact(prog);
+
+    stats.unusedVars = removeUnusedVars(prog);
+    irCompact(prog);
+    irBuildBlocks(prog);
+    return stats;
+}
@@ -0,0 +1,17 @@
+/* deadcode.h - Eliminación de código muerto sobre el código intermedio */
+#ifndef DEADCODE_H
+#define DEADCODE_H
+
+#include "ir.h"
+
+// Resultado de la eliminación
+typedef struct {
+    int unreachable;    // Instrucciones en bloques inalcanzables
+    int deadStores;     // Escrituras cuyo valor nunca se lee
+    int unusedVars;     // Declaraciones VAR sin ningún uso
+} DeadCodeStats;
+
+// Quita código inalcanzable, escrituras muertas y variables sin uso
+DeadCodeStats eliminateDeadCode(IRProgram* prog);
+
+#endif
@@ -0,0 +1,245 @@
+/* gen_corpus.c - Generador de programas .fis sintéticos para benchmarks
+ *
+ * Escribe en stdout un programa válido con aproximadamente N sentencias
+ * de la forma pedida. Cada forma carga una parte distinta del compilador:
+ *
+ *   vars     muchas variables globales (tabla de símbolos, declareVar)
+ *   expr     expresiones largas (análisis de tipos, codegen, CSE)
+ *   nest     bloques anidados con locales en cada nivel
+ *   arrays   arreglos grandes con bucles que los recorren
+ *   blocks   muchos bloques hermanos junto a muchas globales (exitScope)
+ *   funcs    muchas funciones y llamadas (findFunction, expansión en línea)
+ *   mixed    todas las anteriores intercaladas
+ *
+ * Uso: ./gen_corpus <forma> <sentencias> [semilla] > programa.fis
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define EXPR_MAX_TERMS 5000     // Términos por expresión en 'expr'
+#define NEST_MAX_DEPTH 64       // Niveles por grupo en 'nest'
+#define ARRAY_SIZE 1024         // Celdas de cada arreglo en 'arrays'
+#define ARRAY_STMTS 32          // Accesos por arreglo en 'arrays'
+#define MIXED_CHUNK 1000        // Sentencias por tramo en 'mixed'
+#define POOL_SIZE 16            // Variables compartidas por 'expr'
+#define PRINT_EVERY 32          // Sentencias entre PRINT en 'vars'
+
+static FILE* out;
+static unsigned int seed = 12345;
+static int nextId = 0;          // Sufijo único entre tramos de 'mixed'
+
+// Generador lineal congruente: el mismo programa para la misma semilla
+static int randInt(int limit) {
+    seed = seed * 1103515245u + 12345u;
+    return (int)((seed >> 16) % (unsigned int)limit);
+}
+
+// Variable leída con INPUT: el plegado de constantes no la puede
+// propagar y el resto del programa llega completo hasta el código final
+static void declareInput(const char* prefix, int id) {
+    fprintf(out, "int %s%d = 0;\nINPUT %s%d;\n", prefix, id, prefix, id);
+}
+
+/* ============================================================
+   FORMAS
+   Cada una emite hasta 'budget' sentencias y retorna cuántas emitió.
+   ============================================================ */
+
+static int genVars(int budget) {
+    int id = nextId++;
+    int count = budget / 2 > 0 ? budget / 2 : 1;
+    int emitted = 2;
+
+    declareInput("in", id);
+    for (int k = 0; k < count; k++) {
+        fprintf(out, "int v%d_%d = in%d + %d;\n", id, k, id, k % 100);
+        emitted++;
+    }
+    for (; emitted < budget - 1; emitted++) {
+        int a = randInt(count), b = randInt(count), c = randInt(count);
+        fprintf(out, "v%d_%d = v%d_%d + v%d_%d * 2;\n", id, a, id, b, id, c);
+        if (emitted % PRINT_EVERY == 0) {
+            fprintf(out, "PRINT v%d_%d;\n", id, a);
+            emitted++;
+        }
+    }
+    fprintf(out, "PRINT v%d_%d;\n", id, randInt(count));
+    return emitted + 1;
+}
+
+static int genExpr(int budget) {
+    int id = nextId++;
+    int emitted = 0;
+
+    declareInput("in", id);
+    for (int k = 0; k < POOL_SIZE; k++) {
+        fprintf(out, "int x%d_%d = in%d + %d;\n", id, k, id, k + 1);
+    }
+    // 'budget' cuenta términos: expresiones de hasta EXPR_MAX_TERMS
+    for (int e = 0; emitted < budget; e++) {
+        int terms = budget - emitted < EXPR_MAX_TERMS ? budget - emitted : EXPR_MAX_TERMS;
+        fprintf(out, "int e%d_%d = x%d_0", id, e, id);
+        for (int t = 1; t < terms; t++) {
+            int v = randInt(POOL_SIZE);
+            switch (randInt(3)) {
+                case 0: fprintf(out, " + x%d_%d", id, v); break;
+                case 1: fprintf(out, " - x%d_%d * %d", id, v, 1 + randInt(9)); break;
+                default: fprintf(out, " + (x%d_%d - %d)", id, v, randInt(100)); break;
+            }
+        }
+        fprintf(out, ";\nPRINT e%d_%d;\n", id, e);
+        emitted += terms;
+    }
+    return emitted;
+}
+
+static int genNest(int budget) {
+    int id = nextId++;
+    int emitted = 2;
+
+    declareInput("n", id);
+    for (int group = 0; emitted < budget; group++) {
+        int depth = (budget - emitted) / 2;
+        if (depth > NEST_MAX_DEPTH) depth = NEST_MAX_DEPTH;
+        if (depth < 1) depth = 1;
+        for (int d = 0; d < depth; d++) {
+            fprintf(out, "%*sif (n%d < %d) {\n", d * 2, "", id, 1000 + d);
+            fprintf(out, "%*sint l%d_%d = n%d + %d;\n", d * 2 + 2, "", group, d, id, d);
+        }
+        for (int d = depth - 1; d >= 0; d--) {
+            fprintf(out, "%*sn%d = n%d + l%d_%d;\n", d * 2 + 2, "", id, id, group, d);
+            fprintf(out, "%*s}\n", d * 2, "");
+        }
+        emitted += 3 * depth;
+    }
+    fprintf(out, "PRINT n%d;\n", id);
+    return emitted + 1;
+}
+
+static int genArrays(int budget) {
+    int id = nextId++;
+    int emitted = 2;
+
+    declareInput("s", id);
+    for (int a = 0; emitted < budget; a++) {
+        fprintf(out, "int a%d_%d[%d];\n", id, a, ARRAY_SIZE);
+        fprintf(out, "int i%d_%d = 0;\n", id, a);
+        fprintf(out, "while (i%d_%d < %d) {\n", id, a, ARRAY_SIZE);
+        fprintf(out, "  a%d_%d[i%d_%d] = i%d_%d * %d;\n", id, a, id, a, id, a, a + 1);
+        fprintf(out, "  i%d_%d = i%d_%d + 1;\n", id, a, id, a);
+        fprintf(out, "}\n");
+        for (int k = 0; k < ARRAY_STMTS; k++) {
+            fprintf(out, "a%d_%d[%d] = a%d_%d[%d] + s%d;\n", id, a, randInt(ARRAY_SIZE),
+                    id, a, randInt(ARRAY_SIZE), id);
+        }
+        fprintf(out, "s%d = s%d + a%d_%d[%d];\n", id, id, id, a, randInt(ARRAY_SIZE));
+        emitted += ARRAY_STMTS + 5;
+    }
+    fprintf(out, "PRINT s%d;\n", id);
+    return emitted + 1;
+}
+
+static int genBlocks(int budget) {
+    int id = nextId++;
+    int globals = budget / 2 > 0 ? budget / 2 : 1;
+    int emitted = 2;
+
+    declareInput("in", id);
+    for (int k = 0; k < globals; k++) {
+        fprintf(out, "int g%d_%d = in%d + %d;\n", id, k, id, k % 50);
+        emitted++;
+    }
+    for (int b = 0; emitted < budget - 1; b++) {
+        int g = randInt(globals);
+        fprintf(out, "if (g%d_%d > %d) {\n", id, g, b % 25);
+        fprintf(out, "  int t%d = g%d_%d + 1;\n", b, id, g);
+        fprintf(out, "  g%d_%d = t%d;\n", id, g, b);
+        fprintf(out, "}\n");
+        emitted += 3;
+    }
+    fprintf(out, "PRINT g%d_0;\n", id);
+    return emitted + 1;
+}
+
+static int genFuncs(int budget) {
+    int id = nextId++;
+    int funcs = budget / 8 > 0 ? budget / 8 : 1;
+    int emitted = 0;
+
+    // Cada función llama a la anterior: no son hojas y no se expanden
+    for (int f = 0; f < funcs; f++) {
+        fprintf(out, "function int f%d_%d(int a, int b) {\n", id, f);
+        fprintf(out, "  int r = a * b + %d;\n", f);
+        if (f > 0) {
+            fprintf(out, "  r = r + f%d_%d(b, %d);\n", id, f - 1, f % 7);
+            emitted++;
+        }
+        fprintf(out, "  return r;\n}\n");
+        emitted += 3;
+    }
+    declareInput("c", id);
+    emitted += 2;
+    for (; emitted < budget - 1; emitted++) {
+        fprintf(out, "c%d = f%d_%d(c%d, %d) %% 1000;\n", id, id, randInt(funcs), id,
+                randInt(10));
+    }
+    fprintf(out, "PRINT c%d;\n", id);
+    return emitted + 1;
+}
+
+typedef int (*Shape)(int budget);
+
+static const struct {
+    const char* name;
+    Shape gen;
+} shapes[] = {
+    { "vars", genVars },
+    { "expr", genExpr },
+    { "nest", genNest },
+    { "arrays", genArrays },
+    { "blocks", genBlocks },
+    { "funcs", genFuncs },
+};
+
+#define SHAPE_COUNT ((int)(sizeof(shapes) / sizeof(shapes[0])))
+
+static int genMixed(int budget) {
+    int emitted = 0;
+    for (int k = 0; emitted < budget; k = (k + 1) % SHAPE_COUNT) {
+        int chunk = budget - emitted < MIXED_CHUNK ? budget - emitted : MIXED_CHUNK;
+        emitted += shapes[k].gen(chunk);
+    }
+    return emitted;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        fprintf(stderr, "Uso: %s <forma> <sentencias> [semilla]\n", argv[0]);
+        fprintf(stderr, "Formas: vars expr nest arrays blocks funcs mixed\n");
+        return 1;
+    }
+
+    int budget = atoi(argv[2]);
+    if (budget < 1) {
+        fprintf(stderr, "Error: la cantidad de sentencias debe ser positiva\n");
+        return 1;
+    }
+    if (argc > 3) seed = (unsigned int)strtoul(argv[3], NULL, 10);
+
+    Shape gen = NULL;
+    if (strcmp(argv[1], "mixed") == 0) gen = genMixed;
+    for (int k = 0; k < SHAPE_COUNT && !gen; k++) {
+        if (strcmp(argv[1], shapes[k].name) == 0) gen = shapes[k].gen;
+    }
+    if (!gen) {
+        fprintf(stderr, "Error: forma desconocida '%s'\n", argv[1]);
+        return 1;
+    }
+
+    out = stdout;
+    fprintf(out, "// Programa sintético: forma %s, %d sentencias, semilla %u\n\n",
+            argv[1], budget, seed);
+    gen(budget);
+    return 0;
+}
@@ -0,0 +1,401 @@
+/* inline.c - Expansión en línea de funciones pequeñas */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "inline.h"
+
+/*
+ * Una función se expande en línea si es hoja (no llama a nadie), su
+ * cuerpo cabe en INLINE_MAX_NODES y solo tiene un return, como última
+ * sentencia. Hay tres formas de expandir una llamada:
+ *
+ *   1. Función de una sola expresión (return e;) con parámetros int o
+ *      bool: la llamada se reemplaza por e con cada parámetro sustituido
+ *      por su argumento. Vale en cualquier expresión, incluso en la
+ *      condición de un while.
+ *   2. Llamada como sentencia: se asignan los parámetros y se copia el
+ *      cuerpo sin el return final. Solo si ningún argumento tiene
+ *      llamadas: los parámetros se asignan de a uno y una llamada en un
+ *      argumento posterior podría pisar uno ya asignado.
+ *   3. Llamada dentro de una sentencia que se evalúa una sola vez
+ *      (asignación, PRINT, PIXEL, return, condición de if): los
+ *      parámetros y el cuerpo se colocan antes de la sentencia y la
+ *      llamada se reemplaza por la expresión del return. Solo si es la
+ *      única llamada de la sentencia y la función no escribe variables
+ *      globales, para no alterar el orden de las lecturas. Nunca si la
+ *      llamada está en el operando derecho de un && o ||: el cortocircuito
+ *      puede saltarla y el cuerpo adelantado se ejecutaría siempre.
+ *
+ * Las funciones se procesan en orden de definición: una función solo
+ * llama a las definidas antes, así que al llegar a su definición sus
+ * llamadas ya están expandidas y puede volverse hoja.
+ */
+
+typedef struct {
+    ASTNode* node;
+    ASTNode* result;        // Expresión del return final (NULL si no hay)
+    int expressionOnly;     // El cuerpo es solo return e;
+    int writesGlobals;
+} Candidate;
+
+static Candidate* candidates = NULL;
+static int candidateCount = 0;
+static int candidateCapacity = 0;
+static int expanded = 0;
+
+static Candidate* findCandidate(const char* name) {
+    for (int i = 0; i < candidateCount; i++) {
+        if (candidates[i].node->idName == name) return &candidates[i];
+    }
+    return NULL;
+}
+
+/* ============================================================
+   ANÁLISIS DE LA FUNCIÓN
+   ============================================================ */
+
+static int countCalls(ASTNode* node) {
+    if (!node) return 0;
+    int count = (node->type == NODE_CALL) + countCalls(node->next);
+    for (int k = 0; k < AST_KID_COUNT(node); k++) count += countCalls(AST_KIDS(node)[k]);
+    return count;
+}
+
+// Llamadas en el operando derecho de un && o ||: solo se evalúan si el
+// izquierdo no decide el resultado
+static int countGuardedCalls(ASTNode* node) {
+    if (!node) return 0;
+    if (node->type == NODE_AND || node->type == NODE_OR) {
+        return countGuardedCalls(AST_LEFT(node)) + countCalls(AST_RIGHT(node));
+    }
+    int count = countGuardedCalls(node->next);
+    for (int k = 0; k < AST_KID_COUNT(node); k++) count += countGuardedCalls(AST_KIDS(node)[k]);
+    return count;
+}
+
+static int countReturns(ASTNode* node) {
+    if (!node) return 0;
+    int count = (node->type == NODE_RETURN);
+    for (int k = 0; k < AST_KID_COUNT(node); k++) {
+        count += countReturns(AST_KIDS(node)[k]);
+    }
+    return count;
+}
+
+// Un arreglo local se declararía una vez por cada copia
+static int declaresArray(ASTNode* node) {
+    if (!node) return 0;
+    if (node->type == NODE_ARRAY_DECL) return 1;
+    for (int k = 0; k < AST_KID_COUNT(node); k++) {
+        if (declaresArray(AST_KIDS(node)[k])) return 1;
+    }
+    return 0;
+}
+
+// Los locales de la función se llaman funcion__nombre (qualifyLocals)
+static int writesOutside(ASTNode* node, const char* prefix, size_t length) {
+    if (!node) return 0;
+    switch (node->type) {
+        case NODE_ASSIGN:
+        case NODE_ARRAY_DECL:
+        case NODE_KEY:
+        case NODE_INPUT:
+            if (strncmp(node->idName, prefix, length) != 0) return 1;
+            break;
+        default:
+            break;
+    }
+    for (int k = 0; k < AST_KID_COUNT(node); k++) {
+        if (writesOutside(AST_KIDS(node)[k], prefix, length)) return 1;
+    }
+    return 0;
+}
+
+static ASTNode* lastStatement(ASTNode* stmts) {
+    if (stmts && stmts->type == NODE_SEQ) {
+        return AST_STMT(stmts, AST_STMT_COUNT(stmts) - 1);
+    }
+    return stmts;
+}
+
+static void considerFunction(ASTNode* fn) {
+    ASTNode* stmts = AST_BODY(fn) ? AST_BODY(AST_BODY(fn)) : NULL;
+    if (countCalls(stmts) > 0) return;
+    if (countNodes(stmts) > INLINE_MAX_NODES || declaresArray(stmts)) return;
+
+    ASTNode* last = lastStatement(stmts);
+    int returns = countReturns(stmts);
+    if (returns > 1) return;
+    if (returns == 1 && (!last || last->type != NODE_RETURN)) return;
+
+    if (candidateCount == candidateCapacity) {
+        candidateCapacity = candidateCapacity ? candidateCapacity * 2 : 16;
+        candidates = realloc(candidates, sizeof(Candidate) * candidateCapacity);
+    }
+    Candidate* c = &candidates[candidateCount++];
+    c->node = fn;
+    c->result = (returns == 1) ? AST_LEFT(last) : NULL;
+
+    c->expressionOnly = c->result && last == stmts;
+    for (ASTNode* p = AST_PARAMS(fn); p; p = p->next) {
+        if (p->varType != TYPE_INT_T && p->varType != TYPE_BOOL_T) c->expressionOnly = 0;
+    }
+
+    char* prefix = malloc(strlen(fn->idName) + 3);
+    sprintf(prefix, "%s__", fn->idName);
+    c->writesGlobals = writesOutside(stmts, prefix, strlen(prefix));
+    free(prefix);
+}
+
+/* ============================================================
+   COPIAS DEL CUERPO
+   ============================================================ */
+
+// Copia de una expresión sin el resto de su lista (next)
+static ASTNode* cloneExpr(ASTNode* node) {
+    ASTNode* next = node->next;
+    node->next = NULL;
+    ASTNode* copy = cloneAST(node);
+    node->next = next;
+    return copy;
+}
+
+// Reemplaza el nodo por replacement conservando su lugar en la lista
+static void replaceNode(ASTNode* node, ASTNode* replacement) {
+    ASTNode* next = node->next;
+    freeAST(AST_ARGS(node));
+    *node = *replacement;
+    node->next = next;
+    freeNode(replacement);
+}
+
+static ASTNode* findArgument(ASTNode* fn, ASTNode* call, const char* name) {
+    ASTNode* arg = AST_ARGS(call);
+    for (ASTNode* p = AST_PARAMS(fn); p && arg; p = p->next, arg = arg->next) {
+        if (p->idName == name) return arg;
+    }
+    return NULL;
+}
+
+// Sustituye cada parámetro por una copia de su argumento
+static void substituteParams(ASTNode* node, ASTNode* fn, ASTNode* call) {
+    if (!node) return;
+    if (node->type == NODE_ID) {
+        ASTNode* arg = findArgument(fn, call, node->idName);
+        if (arg) {
+            ASTNode* next = node->next;
+            ASTNode* copy = cloneExpr(arg);
+            *node = *copy;
+            node->next = next;
+            freeNode(copy);
+        }
+        return;
+    }
+    for (int k = 0; k < AST_KID_COUNT(node); k++) {
+        substituteParams(AST_KIDS(node)[k], fn, call);
+    }
+}
+
+// param = argumento para cada parámetro, seguido del cuerpo sin el return
+static ASTNode* expandBody(ASTNode* fn, ASTNode* call) {
+    ASTNode* seq = NULL;
+    ASTNode* arg = AST_ARGS(call);
+    for (ASTNode* p = AST_PARAMS(fn); p && arg; p = p->next, arg = arg->next) {
+        ASTNode* bind = newAssign(p->idName, cloneExpr(arg));
+        bind->varType = p->varType;
+        seq = seq ? newSeq(seq, bind) : bind;
+    }
+
+    ASTNode* stmts = AST_BODY(fn) ? AST_BODY(AST_BODY(fn)) : NULL;
+    if (stmts && stmts->type == NODE_SEQ) {
+        int count = AST_STMT_COUNT(stmts);
+        if (lastStatement(stmts)->type == NODE_RETURN) count--;
+        for (int i = 0; i < count; i++) {
+            seq = newSeq(seq, cloneAST(AST_STMT(stmts, i)));
+        }
+    } else if (stmts && stmts->type != NODE_RETURN) {
+        seq = newSeq(seq, cloneAST(stmts));
+    }
+    return seq;
+}
+
+/* ============================================================
+   EXPANSIÓN
+   ============================================================ */
+
+// Forma 1: funciones de una sola expresión, de adentro hacia afuera
+static void inlineExpressions(ASTNode* node) {
+    if (!node) return;
+    if (node->type != NODE_CALL) {
+        for (int k = 0; k < AST_KID_COUNT(node); k++) {
+            inlineExpressions(AST_KIDS(node)[k]);
+        }
+        return;
+    }
+    for (ASTNode* arg = AST_ARGS(node); arg; arg = arg->next) inlineExpressions(arg);
+
+    Candidate* c = findCandidate(node->idName);
+    if (!c || !c->expressionOnly) return;
+    for (ASTNode* arg = AST_ARGS(node); arg; arg = arg->next) {
+        if (countCalls(arg) > 0) return;
+    }
+
+    ASTNode* value = cloneAST(c->result);
+    substituteParams(value, c->node, node);
+    replaceNode(node, value);
+    expanded++;
+}
+
+static ASTNode* findCall(ASTNode* node) {
+    if (!node) return NULL;
+    if (node->type == NODE_CALL) return node;
+    ASTNode* found = NULL;
+    for (int k = 0; k < AST_KID_COUNT(node) && !found; k++) {
+        found = findCall(AST_KIDS(node)[k]);
+    }
+    return found;
+}
+
+// Convierte la sentencia en (prefix; sentencia)
+static void prependStatements(ASTNode* stmt, ASTNode* prefix) {
+    // Nodo nuevo que recibe la sentencia original
+    ASTNode* moved = newBlock(NULL);
+    *moved = *stmt;
+    ASTNode* seq = newSeq(prefix, moved);
+    *stmt = *seq;
+    freeNode(seq);
+}
+
+// Formas 2 y 3 sobre una sentencia
+static void inlineStatement(ASTNode* stmt) {
+    // Llamada como sentencia: se reemplaza por el cuerpo
+    if (stmt->type == NODE_CALL) {
+        Candidate* c = findCandidate(stmt->idName);
+        if (!c) return;
+        for (ASTNode* arg = AST_ARGS(stmt); arg; arg = arg->next) {
+            if (countCalls(arg) > 0) return;
+        }
+        ASTNode* body = expandBody(c->node, stmt);
+        replaceNode(stmt, body ? body : newBlock(NULL));
+        expanded++;
+        return;
+    }
+
+    // Expresiones de la sentencia que se evalúan una vez, en orden
+    ASTNode* parts[3] = { NULL, NULL, NULL };
+    switch (stmt->type) {
+        case NODE_ASSIGN:
+            parts[0] = AST_LEFT(stmt);
+            parts[1] = AST_INDEX(stmt);
+            break;
+        case NODE_PRINT:
+        case NODE_RETURN:
+            parts[0] = AST_LEFT(stmt);
+            break;
+        case NODE_PIXEL:
+            parts[0] = AST_LEFT(stmt);
+            parts[1] = AST_RIGHT(stmt);
+            parts[2] = AST_EXTRA(stmt);
+            break;
+        case NODE_IF:
+        case NODE_IF_ELSE:
+            parts[0] = AST_COND(stmt);
+            break;
+        default:
+            return;
+    }
+
+    int calls = 0;
+    int guarded = 0;
+    ASTNode* call = NULL;
+    for (int i = 0; i < 3; i++) {
+        calls += countCalls(parts[i]);
+        guarded += countGuardedCalls(parts[i]);
+        if (!call) call = findCall(parts[i]);
+    }
+    if (calls != 1 || guarded > 0) return;
+
+    Candidate* c = findCandidate(call->idName);
+    if (!c || !c->result || c->writesGlobals) return;
+
+    ASTNode* body = expandBody(c->node, call);
+    replaceNode(call, cloneAST(c->result));
+    if (body) prependStatements(stmt, body);
+    expanded++;
+}
+
+// Recorre las sentencias en orden de definición
+static void inlineStatements(ASTNode* node) {
+    if (!node) return;
+
+    switch (node->type) {
+        case NODE_SEQ:
+            for (int i = 0; i < AST_STMT_COUNT(node); i++) {
+                inlineStatements(AST_STMT(node, i));
+            }
+            return;
+
+        case NODE_BLOCK:
+            inlineStatements(AST_BODY(node));
+            return;
+
+        case NODE_FUNCTION:
+            inlineStatements(AST_BODY(node));
+            considerFunction(node);
+            return;
+
+        case NODE_IF:
+        case NODE_IF_ELSE:
+            inlineStatements(AST_BODY(node));
+            inlineStatements(AST_ELSE(node));
+            inlineExpressions(AST_COND(node));
+            break;
+
+        case NODE_WHILE:
+            inlineStatements(AST_BODY(node));
+            inlineExpressions(AST_COND(node));
+            return;
+
+        case NODE_FOR:
+            inlineStatements(AST_INIT(node));
+            inlineStatements(AST_BODY(node));
+            inlineExpressions(AST_COND(node));
+            return;
+
+        case NODE_ASSIGN:
+            inlineExpressions(AST_LEFT(node));
+            inlineExpressions(AST_INDEX(node));
+            break;
+
+        case NODE_PIXEL:
+            inlineExpressions(AST_LEFT(node));
+            inlineExpressions(AST_RIGHT(node));
+            inlineExpressions(AST_EXTRA(node));
+            break;
+
+        case NODE_PRINT:
+        case NODE_RETURN:
+            inlineExpressions(AST_LEFT(node));
+            break;
+
+        case NODE_CALL:
+            for (ASTNode* arg = AST_ARGS(node); arg; arg = arg->next) inlineExpressions(arg);
+            break;
+
+        default:
+            return;
+    }
+
+    inlineStatement(node);
+}
+
+int inlineFunctions(ASTNode* root) {
+    expanded = 0;
+    inlineStatements(root);
+
+    free(candidates);
+    candidates = NULL;
+    candidateCount = 0;
+    candidateCapacity = 0;
+    return expanded;
+}
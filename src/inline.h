@@ -0,0 +1,13 @@
+/* inline.h - Expansión en línea de funciones pequeñas */
+#ifndef INLINE_H
+#define INLINE_H
+
+#include "ast.h"
+
+// Tamaño máximo (nodos del cuerpo) de una función que se expande en línea
+#define INLINE_MAX_NODES 40
+
+// Expande las llamadas a funciones hoja pequeñas; retorna cuántas
+int inlineFunctions(ASTNode* root);
+
+#endif
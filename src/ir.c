@@ -0,0 +1,915 @@
+/* ir.c - Representación intermedia de tres direcciones FIS-25 */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ir.h"
+
+#define IR_INITIAL_CAPACITY 256
+#define OUT_BUFFER_SIZE 65536
+
+static unsigned int hashName(const char* str) {
+    unsigned int hash = 5381;
+    int c;
+    while ((c = *str++))
+        hash = ((hash << 5) + hash) + c;
+    return hash;
+}
+
+/* ============================================================
+   CREACIÓN Y DESTRUCCIÓN
+   ============================================================ */
+
+IRProgram* irCreate() {
+    IRProgram* prog = malloc(sizeof(IRProgram));
+    if (!prog) {
+        fprintf(stderr, "Error: No se pudo asignar memoria para el IR\n");
+        exit(1);
+    }
+    prog->code = malloc(sizeof(IRInstr) * IR_INITIAL_CAPACITY);
+    prog->count = 0;
+    prog->capacity = IR_INITIAL_CAPACITY;
+    prog->blocks = NULL;
+    prog->blockCount = 0;
+    prog->loops = NULL;
+    prog->loopCount = 0;
+    prog->loopCapacity = 0;
+    prog->strings = NULL;
+    prog->stringCount = 0;
+    prog->stringCapacity = 0;
+    return prog;
+}
+
+void irFree(IRProgram* prog) {
+    if (!prog) return;
+    free(prog->code);
+    free(prog->blocks);
+    free(prog->loops);
+    for (int i = 0; i < prog->stringCount; i++) free(prog->strings[i]);
+    free(prog->strings);
+    free(prog);
+}
+
+/* ============================================================
+   OPERANDOS
+   ============================================================ */
+
+Operand opNone() {
+    Operand o = { OPD_NONE, 0, 0.0f, NULL, 0 };
+    return o;
+}
+
+Operand opVar(const char* name) {
+    Operand o = { OPD_VAR, 0, 0.0f, name, 0 };
+    return o;
+}
+
+Operand opTemp(int num) {
+    Operand o = { OPD_TEMP, num, 0.0f, NULL, 0 };
+    return o;
+}
+
+Operand opInt(int value) {
+    Operand o = { OPD_INT, value, 0.0f, NULL, 0 };
+    return o;
+}
+
+Operand opFloat(float value) {
+    Operand o = { OPD_FLOAT, 0, value, NULL, 0 };
+    return o;
+}
+
+Operand opString(const char* str) {
+    Operand o = { OPD_STRING, 0, 0.0f, str, 0 };
+    return o;
+}
+
+Operand opElem(const char* array, int index) {
+    Operand o = { OPD_ELEM, index, 0.0f, array, 0 };
+    return o;
+}
+
+/* ============================================================
+   EMISIÓN
+   ============================================================ */
+
+static IRInstr* appendInstr(IRProgram* prog, IROpcode op) {
+    if (prog->count == prog->capacity) {
+        prog->capacity *= 2;
+        prog->code = realloc(prog->code, sizeof(IRInstr) * prog->capacity);
+        if (!prog->code) {
+            fprintf(stderr, "Error: No se pudo ampliar el IR\n");
+            exit(1);
+        }
+    }
+    IRInstr* ins = &prog->code[prog->count++];
+    ins->op = op;
+    ins->dst = opNone();
+    ins->a = opNone();
+    ins->b = opNone();
+    ins->c = opNone();
+    ins->label = -1;
+    ins->leader = 0;
+    return ins;
+}
+
+IRInstr* irEmit(IRProgram* prog, IROpcode op, Operand dst, Operand a, Operand b) {
+    IRInstr* ins = appendInstr(prog, op);
+    ins->dst = dst;
+    ins->a = a;
+    ins->b = b;
+    return ins;
+}
+
+// Instrucciones sin destino y con tres operandos (PIXEL, STORE)
+IRInstr* irEmitTernary(IRProgram* prog, IROpcode op, Operand a, Operand b, Operand c) {
+    IRInstr* ins = appendInstr(prog, op);
+    ins->a = a;
+    ins->b = b;
+    ins->c = c;
+    return ins;
+}
+
+// LABEL, GOTO e IFFALSE/IFTRUE (cond solo aplica a los condicionales)
+IRInstr* irEmitJump(IRProgram* prog, IROpcode op, Operand cond, int label) {
+    IRInstr* ins = appendInstr(prog, op);
+    ins->a = cond;
+    ins->label = label;
+    return ins;
+}
+
+/* ============================================================
+   BUCLES
+   ============================================================ */
+
+void irAddLoop(IRProgram* prog, int bodyLabel, int endLabel, int depth) {
+    if (prog->loopCount == prog->loopCapacity) {
+        prog->loopCapacity = prog->loopCapacity ? prog->loopCapacity * 2 : 16;
+        prog->loops = realloc(prog->loops, sizeof(IRLoop) * prog->loopCapacity);
+    }
+    IRLoop* loop = &prog->loops[prog->loopCount++];
+    loop->bodyLabel = bodyLabel;
+    loop->endLabel = endLabel;
+    loop->depth = depth;
+    loop->hasCall = 0;
+}
+
+// Posición de LABEL label en el código (-1 si no existe)
+int irFindLabel(IRProgram* prog, int label) {
+    for (int i = 0; i < prog->count; i++) {
+        if (prog->code[i].op == IR_LABEL && prog->code[i].label == label) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* ============================================================
+   BLOQUES BÁSICOS
+   ============================================================ */
+
+// Marca los líderes y construye la lista de bloques básicos.
+// Un líder es la primera instrucción, cada LABEL y cada instrucción
+// que sigue a un salto o a un RETURN.
+int irBuildBlocks(IRProgram* prog) {
+    free(prog->blocks);
+    prog->blocks = malloc(sizeof(IRBlock) * (prog->count + 1));
+    prog->blockCount = 0;
+
+    for (int i = 0; i < prog->count; i++) {
+        IRInstr* ins = &prog->code[i];
+        ins->leader = (i == 0) || ins->op == IR_LABEL;
+        if (i > 0) {
+            IROpcode prev = prog->code[i - 1].op;
+            if (irIsJump(prev) || prev == IR_RETURN) {
+                ins->leader = 1;
+            }
+        }
+        if (ins->leader) {
+            if (prog->blockCount > 0) {
+                prog->blocks[prog->blockCount - 1].end = i;
+            }
+            prog->blocks[prog->blockCount].start = i;
+            prog->blocks[prog->blockCount].end = prog->count;
+            prog->blockCount++;
+        }
+    }
+    return prog->blockCount;
+}
+
+// Mapa etiqueta -> bloque que la contiene (-1 si no existe).
+// Requiere irBuildBlocks; el llamador libera el arreglo.
+int* irLabelBlockMap(IRProgram* prog, int* labelLimit) {
+    int limit = 0;
+    for (int i = 0; i < prog->count; i++) {
+        if (prog->code[i].label >= limit) limit = prog->code[i].label + 1;
+    }
+    int* map = malloc(sizeof(int) * (limit + 1));
+    for (int i = 0; i < limit; i++) map[i] = -1;
+
+    for (int b = 0; b < prog->blockCount; b++) {
+        for (int i = prog->blocks[b].start; i < prog->blocks[b].end; i++) {
+            if (prog->code[i].op == IR_LABEL) map[prog->code[i].label] = b;
+        }
+    }
+    if (labelLimit) *labelLimit = limit;
+    return map;
+}
+
+// Sucesores de un bloque: salto explícito y/o caída al siguiente
+int irBlockSuccessors(IRProgram* prog, int block, int* labelBlock, int succ[2]) {
+    int n = 0;
+    int last = prog->blocks[block].end - 1;
+    IRInstr* ins = &prog->code[last];
+
+    if (ins->op == IR_RETURN) return 0;
+    if (irIsJump(ins->op)) {
+        succ[n++] = labelBlock[ins->label];
+        if (ins->op == IR_GOTO) return n;
+    }
+    if (block + 1 < prog->blockCount) {
+        succ[n++] = block + 1;
+    }
+    return n;
+}
+
+/* ============================================================
+   USOS Y DEFINICIONES
+   ============================================================ */
+
+static int isValueOperand(Operand* o) {
+    return o->kind == OPD_VAR || o->kind == OPD_TEMP || o->kind == OPD_ELEM;
+}
+
+// Llena uses con los operandos que la instrucción lee; retorna cuántos
+int irUses(IRInstr* ins, Operand* uses[3]) {
+    int n = 0;
+    if (ins->op == IR_VAR || ins->op == IR_NOP || ins->op == IR_COMMENT) return 0;
+    if (isValueOperand(&ins->a)) uses[n++] = &ins->a;
+    if (isValueOperand(&ins->b)) uses[n++] = &ins->b;
+    if (isValueOperand(&ins->c)) uses[n++] = &ins->c;
+    return n;
+}
+
+// Operando que la instrucción escribe (NULL si no escribe ninguno)
+Operand* irDef(IRInstr* ins) {
+    switch (ins->op) {
+        case IR_ASSIGN:
+        case IR_LOAD:
+        case IR_KEY:
+        case IR_INPUT:
+            return &ins->dst;
+        default:
+            return irIsBinary(ins->op) ? &ins->dst : NULL;
+    }
+}
+
+// Elimina las instrucciones NOP
+void irCompact(IRProgram* prog) {
+    int n = 0;
+    for (int i = 0; i < prog->count; i++) {
+        if (prog->code[i].op != IR_NOP) {
+            prog->code[n++] = prog->code[i];
+        }
+    }
+    prog->count = n;
+}
+
+// Inserta todas las instrucciones pendientes en una sola reconstrucción.
+// Las de una misma posición conservan su orden; los NOP se descartan.
+void irApplyInsertions(IRProgram* prog, IRInsertion* list, int count) {
+    // Conteo por posición (orden estable)
+    int* first = calloc(prog->count + 2, sizeof(int));
+    for (int k = 0; k < count; k++) first[list[k].pos + 1]++;
+    for (int i = 0; i <= prog->count; i++) first[i + 1] += first[i];
+
+    IRInstr* sorted = malloc(sizeof(IRInstr) * (count + 1));
+    int* fill = malloc(sizeof(int) * (prog->count + 1));
+    memcpy(fill, first, sizeof(int) * (prog->count + 1));
+    for (int k = 0; k < count; k++) {
+        sorted[fill[list[k].pos]++] = list[k].ins;
+    }
+
+    int capacity = prog->count + count + 1;
+    IRInstr* code = malloc(sizeof(IRInstr) * capacity);
+    int n = 0;
+    for (int i = 0; i <= prog->count; i++) {
+        for (int k = first[i]; k < first[i + 1]; k++) {
+            code[n] = sorted[k];
+            code[n++].leader = 0;
+        }
+        if (i < prog->count && prog->code[i].op != IR_NOP) {
+            code[n++] = prog->code[i];
+        }
+    }
+    free(prog->code);
+    prog->code = code;
+    prog->count = n;
+    prog->capacity = capacity;
+
+    free(first);
+    free(sorted);
+    free(fill);
+}
+
+/* ============================================================
+   SERIALIZACIÓN
+   ============================================================ */
+
+// Buffer de salida propio: evita el formateo de stdio por instrucción
+typedef struct {
+    FILE* out;
+    char data[OUT_BUFFER_SIZE];
+    int pos;
+} OutBuffer;
+
+static void flushBuffer(OutBuffer* buf) {
+    fwrite(buf->data, 1, buf->pos, buf->out);
+    buf->pos = 0;
+}
+
+static void putStr(OutBuffer* buf, const char* s) {
+    while (*s) {
+        if (buf->pos == OUT_BUFFER_SIZE) flushBuffer(buf);
+        buf->data[buf->pos++] = *s++;
+    }
+}
+
+static void putChar(OutBuffer* buf, char c) {
+    if (buf->pos == OUT_BUFFER_SIZE) flushBuffer(buf);
+    buf->data[buf->pos++] = c;
+}
+
+static void putInt(OutBuffer* buf, int value) {
+    char digits[12];
+    int n = 0;
+    unsigned int v = value < 0 ? -(unsigned int)value : (unsigned int)value;
+
+    if (value < 0) putChar(buf, '-');
+    do {
+        digits[n++] = '0' + (v % 10);
+        v /= 10;
+    } while (v);
+    while (n > 0) putChar(buf, digits[--n]);
+}
+
+static void putOperand(OutBuffer* buf, Operand o) {
+    switch (o.kind) {
+        case OPD_VAR:
+            putStr(buf, o.name);
+            break;
+        case OPD_TEMP:
+            putChar(buf, 'T');
+            putInt(buf, o.num);
+            break;
+        case OPD_INT:
+            putInt(buf, o.num);
+            break;
+        case OPD_FLOAT: {
+            char text[64];
+            snprintf(text, sizeof(text), "%.6f", o.fnum);
+            putStr(buf, text);
+            break;
+        }
+        case OPD_STRING:
+            putChar(buf, '"');
+            putStr(buf, o.name);
+            putChar(buf, '"');
+            break;
+        case OPD_ELEM:
+            putStr(buf, o.name);
+            putChar(buf, '[');
+            putInt(buf, o.num);
+            putChar(buf, ']');
+            break;
+        default:
+            break;
+    }
+}
+
+static void putLabel(OutBuffer* buf, int label) {
+    putChar(buf, 'L');
+    putInt(buf, label);
+}
+
+static void printInstr(OutBuffer* buf, IRInstr* ins) {
+    if (ins->op == IR_NOP) return;
+
+    if (ins->op == IR_COMMENT) {
+        putStr(buf, "// ");
+        putStr(buf, ins->a.name);
+        putChar(buf, '\n');
+        return;
+    }
+
+    putStr(buf, irOpcodeName(ins->op));
+
+    switch (ins->op) {
+        case IR_VAR:
+            putChar(buf, ' ');
+            putOperand(buf, ins->dst);
+            // Arreglo: un solo bloque contiguo de a celdas
+            if (ins->a.kind == OPD_INT) {
+                putChar(buf, '[');
+                putInt(buf, ins->a.num);
+                putChar(buf, ']');
+            }
+            break;
+
+        case IR_INPUT:
+            putChar(buf, ' ');
+            putOperand(buf, ins->dst);
+            break;
+
+        case IR_ASSIGN:
+        case IR_KEY:
+            putChar(buf, ' ');
+            putOperand(buf, ins->a);
+            putChar(buf, ' ');
+            putOperand(buf, ins->dst);
+            break;
+
+        case IR_LOAD:
+            putChar(buf, ' ');
+            putOperand(buf, ins->a);
+            putChar(buf, ' ');
+            putOperand(buf, ins->b);
+            putChar(buf, ' ');
+            putOperand(buf, ins->dst);
+            break;
+
+        case IR_STORE:
+        case IR_PIXEL:
+            putChar(buf, ' ');
+            putOperand(buf, ins->a);
+            putChar(buf, ' ');
+            putOperand(buf, ins->b);
+            putChar(buf, ' ');
+            putOperand(buf, ins->c);
+            break;
+
+        case IR_PRINT:
+            putChar(buf, ' ');
+            putOperand(buf, ins->a);
+            break;
+
+        case IR_LABEL:
+        case IR_GOTO:
+            putChar(buf, ' ');
+            putLabel(buf, ins->label);
+            break;
+
+        case IR_IFFALSE:
+        case IR_IFTRUE:
+            putChar(buf, ' ');
+            putOperand(buf, ins->a);
+            putStr(buf, " GOTO ");
+            putLabel(buf, ins->label);
+            break;
+
+        case IR_IFEQ:
+        case IR_IFNEQ:
+        case IR_IFLT:
+        case IR_IFGT:
+        case IR_IFLTE:
+        case IR_IFGTE:
+            putChar(buf, ' ');
+            putOperand(buf, ins->a);
+            putChar(buf, ' ');
+            putOperand(buf, ins->b);
+            putStr(buf, " GOTO ");
+            putLabel(buf, ins->label);
+            break;
+
+        case IR_RETURN:
+            if (ins->a.kind != OPD_NONE) {
+                putChar(buf, ' ');
+                putOperand(buf, ins->a);
+            }
+            break;
+
+        default:
+            if (irIsBinary(ins->op)) {
+                putChar(buf, ' ');
+                putOperand(buf, ins->a);
+                putChar(buf, ' ');
+                putOperand(buf, ins->b);
+                putChar(buf, ' ');
+                putOperand(buf, ins->dst);
+            }
+            break;
+    }
+    putChar(buf, '\n');
+}
+
+// Escribe el programa completo como texto FIS-25
+void irPrint(IRProgram* prog, FILE* out) {
+    OutBuffer* buf = malloc(sizeof(OutBuffer));
+    buf->out = out;
+    buf->pos = 0;
+
+    for (int i = 0; i < prog->count; i++) {
+        printInstr(buf, &prog->code[i]);
+    }
+
+    flushBuffer(buf);
+    free(buf);
+}
+
+/* ============================================================
+   LECTURA
+   ============================================================ */
+
+// Copia un texto y lo deja a cargo del programa (se libera en irFree)
+static char* ownString(IRProgram* prog, const char* text, int length) {
+    if (prog->stringCount == prog->stringCapacity) {
+        prog->stringCapacity = prog->stringCapacity ? prog->stringCapacity * 2 : 64;
+        prog->strings = realloc(prog->strings, sizeof(char*) * prog->stringCapacity);
+    }
+    char* copy = malloc(length + 1);
+    memcpy(copy, text, length);
+    copy[length] = '\0';
+    prog->strings[prog->stringCount++] = copy;
+    return copy;
+}
+
+// Lee una línea completa; retorna NULL al final del archivo
+static char* readLine(FILE* in, char** line, int* capacity) {
+    int length = 0;
+    int c;
+    while ((c = getc(in)) != EOF && c != '\n') {
+        if (length + 1 >= *capacity) {
+            *capacity *= 2;
+            *line = realloc(*line, *capacity);
+        }
+        (*line)[length++] = (char)c;
+    }
+    if (c == EOF && length == 0) return NULL;
+    if (length > 0 && (*line)[length - 1] == '\r') length--;
+    (*line)[length] = '\0';
+    return *line;
+}
+
+// Separa la línea en palabras; las cadenas entre comillas son una sola
+static int splitTokens(char* line, char** tokens, int max) {
+    int n = 0;
+    char* p = line;
+    while (*p && n < max) {
+        while (*p == ' ' || *p == '\t') p++;
+        if (!*p) break;
+        tokens[n++] = p;
+        if (*p == '"') {
+            p++;
+            while (*p && *p != '"') {
+                if (*p == '\\' && p[1]) p++;
+                p++;
+            }
+            if (*p) p++;
+        } else {
+            while (*p && *p != ' ' && *p != '\t') p++;
+        }
+        if (*p) *p++ = '\0';
+    }
+    return n;
+}
+
+static int isNumber(const char* s) {
+    if (*s == '-') s++;
+    if (!*s) return 0;
+    int digits = 0;
+    for (; *s; s++) {
+        if (*s >= '0' && *s <= '9') digits++;
+        else if (*s != '.') return 0;
+    }
+    return digits > 0;
+}
+
+static Operand parseOperand(IRProgram* prog, const char* text) {
+    int length = strlen(text);
+
+    if (text[0] == '"') {
+        int end = length > 1 && text[length - 1] == '"' ? length - 1 : length;
+        return opString(ownString(prog, text + 1, end - 1));
+    }
+    if (isNumber(text)) {
+        if (strchr(text, '.')) return opFloat((float)atof(text));
+        return opInt(atoi(text));
+    }
+    if (text[0] == 'T' && length > 1 && isNumber(text + 1) && !strchr(text, '.')) {
+        return opTemp(atoi(text + 1));
+    }
+    const char* bracket = strchr(text, '[');
+    if (bracket && text[length - 1] == ']') {
+        char* name = ownString(prog, text, bracket - text);
+        return opElem(name, atoi(bracket + 1));
+    }
+    return opVar(ownString(prog, text, length));
+}
+
+static int parseLabel(const char* text) {
+    return (text[0] == 'L') ? atoi(text + 1) : -1;
+}
+
+static int parseOpcode(const char* text, IROpcode* op) {
+    for (int k = IR_VAR; k < IR_NOP; k++) {
+        if (k != IR_COMMENT && strcmp(irOpcodeName((IROpcode)k), text) == 0) {
+            *op = (IROpcode)k;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Cantidad de palabras que espera cada instrucción (sin el código)
+static int expectedOperands(IROpcode op) {
+    switch (op) {
+        case IR_VAR:
+        case IR_INPUT:
+        case IR_PRINT:
+        case IR_LABEL:
+        case IR_GOTO:
+            return 1;
+        case IR_ASSIGN:
+        case IR_KEY:
+            return 2;
+        case IR_IFFALSE:
+        case IR_IFTRUE:
+            return 3;
+        case IR_IFEQ:
+        case IR_IFNEQ:
+        case IR_IFLT:
+        case IR_IFGT:
+        case IR_IFLTE:
+        case IR_IFGTE:
+            return 4;
+        default:
+            return 3;
+    }
+}
+
+// Lee un programa FIS-25 en texto (el formato que produce irPrint).
+// Retorna NULL e informa la línea si encuentra algo que no reconoce.
+IRProgram* irParse(FILE* in) {
+    IRProgram* prog = irCreate();
+    int capacity = 256;
+    char* line = malloc(capacity);
+    int lineNumber = 0;
+
+    while (readLine(in, &line, &capacity)) {
+        lineNumber++;
+        char* p = line;
+        while (*p == ' ' || *p == '\t') p++;
+        if (!*p) continue;
+
+        if (p[0] == '/' && p[1] == '/') {
+            p += 2;
+            if (*p == ' ') p++;
+            irEmit(prog, IR_COMMENT, opNone(), opString(ownString(prog, p, strlen(p))), opNone());
+            continue;
+        }
+
+        char* tokens[8];
+        int n = splitTokens(p, tokens, 8);
+        IROpcode op;
+        if (!parseOpcode(tokens[0], &op)) {
+            fprintf(stderr, "Error: línea %d: instrucción desconocida '%s'\n",
+                    lineNumber, tokens[0]);
+            free(line);
+            irFree(prog);
+            return NULL;
+        }
+
+        int args = n - 1;
+        int ok;
+        if (op == IR_RETURN) {
+            ok = args <= 1;
+        } else {
+            ok = args == expectedOperands(op);
+        }
+        if (!ok) {
+            fprintf(stderr, "Error: línea %d: operandos incorrectos para %s\n",
+                    lineNumber, tokens[0]);
+            free(line);
+            irFree(prog);
+            return NULL;
+        }
+
+        switch (op) {
+            case IR_VAR: {
+                Operand o = parseOperand(prog, tokens[1]);
+                if (o.kind == OPD_ELEM) {
+                    irEmit(prog, IR_VAR, opVar(o.name), opInt(o.num), opNone());
+                } else {
+                    irEmit(prog, IR_VAR, o, opNone(), opNone());
+                }
+                break;
+            }
+            case IR_INPUT:
+                irEmit(prog, op, parseOperand(prog, tokens[1]), opNone(), opNone());
+                break;
+            case IR_PRINT:
+                irEmit(prog, op, opNone(), parseOperand(prog, tokens[1]), opNone());
+                break;
+            case IR_RETURN:
+                irEmit(prog, op, opNone(),
+                       args == 1 ? parseOperand(prog, tokens[1]) : opNone(), opNone());
+                break;
+            case IR_ASSIGN:
+            case IR_KEY:
+                irEmit(prog, op, parseOperand(prog, tokens[2]),
+                       parseOperand(prog, tokens[1]), opNone());
+                break;
+            case IR_LABEL:
+            case IR_GOTO:
+                irEmitJump(prog, op, opNone(), parseLabel(tokens[1]));
+                break;
+            case IR_IFFALSE:
+            case IR_IFTRUE:
+                irEmitJump(prog, op, parseOperand(prog, tokens[1]), parseLabel(tokens[3]));
+                break;
+            case IR_STORE:
+            case IR_PIXEL:
+                irEmitTernary(prog, op, parseOperand(prog, tokens[1]),
+                              parseOperand(prog, tokens[2]), parseOperand(prog, tokens[3]));
+                break;
+            default:
+                if (irIsCompareJump(op)) {
+                    IRInstr* ins = irEmitJump(prog, op, parseOperand(prog, tokens[1]),
+                                              parseLabel(tokens[4]));
+                    ins->b = parseOperand(prog, tokens[2]);
+                } else {
+                    // Binarias y LOAD: a b dst
+                    irEmit(prog, op, parseOperand(prog, tokens[3]),
+                           parseOperand(prog, tokens[1]), parseOperand(prog, tokens[2]));
+                }
+                break;
+        }
+    }
+
+    free(line);
+    irBuildBlocks(prog);
+    return prog;
+}
+
+/* ============================================================
+   UTILIDADES
+   ============================================================ */
+
+const char* irOpcodeName(IROpcode op) {
+    switch (op) {
+        case IR_VAR: return "VAR";
+        case IR_ASSIGN: return "ASSIGN";
+        case IR_ADD: return "ADD";
+        case IR_SUB: return "SUB";
+        case IR_MUL: return "MUL";
+        case IR_DIV: return "DIV";
+        case IR_MOD: return "MOD";
+        case IR_EQ: return "EQ";
+        case IR_NEQ: return "NEQ";
+        case IR_LT: return "LT";
+        case IR_GT: return "GT";
+        case IR_LTE: return "LTE";
+        case IR_GTE: return "GTE";
+        case IR_LOAD: return "LOAD";
+        case IR_STORE: return "STORE";
+        case IR_PIXEL: return "PIXEL";
+        case IR_KEY: return "KEY";
+        case IR_INPUT: return "INPUT";
+        case IR_PRINT: return "PRINT";
+        case IR_LABEL: return "LABEL";
+        case IR_GOTO: return "GOTO";
+        case IR_IFFALSE: return "IFFALSE";
+        case IR_IFTRUE: return "IFTRUE";
+        case IR_IFEQ: return "IFEQ";
+        case IR_IFNEQ: return "IFNEQ";
+        case IR_IFLT: return "IFLT";
+        case IR_IFGT: return "IFGT";
+        case IR_IFLTE: return "IFLTE";
+        case IR_IFGTE: return "IFGTE";
+        case IR_RETURN: return "RETURN";
+        case IR_COMMENT: return "//";
+        case IR_NOP: return "NOP";
+        default: return "UNKNOWN";
+    }
+}
+
+int irIsBinary(IROpcode op) {
+    return op >= IR_ADD && op <= IR_GTE;
+}
+
+int irIsJump(IROpcode op) {
+    return op == IR_GOTO || op == IR_IFFALSE || op == IR_IFTRUE ||
+           irIsCompareJump(op);
+}
+
+int irIsCompareJump(IROpcode op) {
+    return op >= IR_IFEQ && op <= IR_IFGTE;
+}
+
+// Salto fusionado para una comparación (negate: saltar si es falsa)
+IROpcode irCompareJumpFor(IROpcode cmp, int negate) {
+    switch (cmp) {
+        case IR_EQ:  return negate ? IR_IFNEQ : IR_IFEQ;
+        case IR_NEQ: return negate ? IR_IFEQ : IR_IFNEQ;
+        case IR_LT:  return negate ? IR_IFGTE : IR_IFLT;
+        case IR_GT:  return negate ? IR_IFLTE : IR_IFGT;
+        case IR_LTE: return negate ? IR_IFGT : IR_IFLTE;
+        case IR_GTE: return negate ? IR_IFLT : IR_IFGTE;
+        default:     return IR_NOP;
+    }
+}
+
+int irOperandEquals(Operand x, Operand y) {
+    if (x.kind != y.kind) return 0;
+    switch (x.kind) {
+        case OPD_NONE:
+            return 1;
+        case OPD_VAR:
+        case OPD_STRING:
+            return x.name == y.name || strcmp(x.name, y.name) == 0;
+        case OPD_ELEM:
+            return x.num == y.num &&
+                   (x.name == y.name || strcmp(x.name, y.name) == 0);
+        case OPD_FLOAT:
+            return x.fnum == y.fnum;
+        default:
+            return x.num == y.num;
+    }
+}
+
+// Número de instrucciones que llegan a la salida
+int irInstructionCount(IRProgram* prog) {
+    int count = 0;
+    for (int i = 0; i < prog->count; i++) {
+        if (prog->code[i].op != IR_NOP && prog->code[i].op != IR_COMMENT) {
+            count++;
+        }
+    }
+    return count;
+}
+
+// Número de temporal más alto usado + 1
+int irMaxTemp(IRProgram* prog) {
+    int max = 0;
+    for (int i = 0; i < prog->count; i++) {
+        IRInstr* ins = &prog->code[i];
+        Operand* ops[4] = { &ins->dst, &ins->a, &ins->b, &ins->c };
+        for (int k = 0; k < 4; k++) {
+            if (ops[k]->kind == OPD_TEMP && ops[k]->num >= max) {
+                max = ops[k]->num + 1;
+            }
+        }
+    }
+    return max;
+}
+
+// Asigna un número denso (campo id) a cada variable y arreglo usado.
+// Retorna la cantidad de variables distintas.
+int irNumberVariables(IRProgram* prog) {
+    int capacity = 256;
+    while (capacity < prog->count) capacity *= 2;
+    const char** names = calloc(capacity, sizeof(char*));
+    int* ids = malloc(sizeof(int) * capacity);
+    int count = 0;
+
+    for (int i = 0; i < prog->count; i++) {
+        IRInstr* ins = &prog->code[i];
+        Operand* ops[4] = { &ins->dst, &ins->a, &ins->b, &ins->c };
+        for (int k = 0; k < 4; k++) {
+            Operand* o = ops[k];
+            if (o->kind != OPD_VAR && o->kind != OPD_ELEM) continue;
+
+            if ((count + 1) * 2 > capacity) {
+                // Crecer la tabla y reinsertar
+                int newCapacity = capacity * 2;
+                const char** newNames = calloc(newCapacity, sizeof(char*));
+                int* newIds = malloc(sizeof(int) * newCapacity);
+                for (int j = 0; j < capacity; j++) {
+                    if (!names[j]) continue;
+                    unsigned int h = hashName(names[j]) & (newCapacity - 1);
+                    while (newNames[h]) h = (h + 1) & (newCapacity - 1);
+                    newNames[h] = names[j];
+                    newIds[h] = ids[j];
+                }
+                free(names);
+                free(ids);
+                names = newNames;
+                ids = newIds;
+                capacity = newCapacity;
+            }
+
+            unsigned int h = hashName(o->name) & (capacity - 1);
+            while (names[h] && names[h] != o->name && strcmp(names[h], o->name) != 0) {
+                h = (h + 1) & (capacity - 1);
+            }
+            if (!names[h]) {
+                names[h] = o->name;
+                ids[h] = count++;
+            }
+            o->id = ids[h];
+        }
+    }
+
+    free(names);
+    free(ids);
+    return count;
+}
@@ -0,0 +1,161 @@
+/* ir.h - Representación intermedia de tres direcciones FIS-25 */
+#ifndef IR_H
+#define IR_H
+
+#include <stdio.h>
+
+// Códigos de operación (uno por instrucción FIS-25)
+typedef enum {
+    IR_VAR,         // VAR dst  /  VAR dst[a] para arreglos
+    IR_ASSIGN,      // ASSIGN a dst
+    IR_ADD,         // ADD a b dst
+    IR_SUB,
+    IR_MUL,
+    IR_DIV,
+    IR_MOD,
+    IR_EQ,
+    IR_NEQ,
+    IR_LT,
+    IR_GT,
+    IR_LTE,
+    IR_GTE,
+    IR_LOAD,        // LOAD base index dst  (dst = base[index])
+    IR_STORE,       // STORE a base index   (base[index] = a)
+    IR_PIXEL,       // PIXEL a b c
+    IR_KEY,         // KEY a dst
+    IR_INPUT,       // INPUT dst
+    IR_PRINT,       // PRINT a
+    IR_LABEL,       // LABEL Ln
+    IR_GOTO,        // GOTO Ln
+    IR_IFFALSE,     // IFFALSE a GOTO Ln
+    IR_IFTRUE,      // IFTRUE a GOTO Ln
+    IR_IFEQ,        // IFEQ a b GOTO Ln  (comparación y salto fusionados)
+    IR_IFNEQ,
+    IR_IFLT,
+    IR_IFGT,
+    IR_IFLTE,
+    IR_IFGTE,
+    IR_RETURN,      // RETURN [a]
+    IR_COMMENT,     // // texto
+    IR_NOP          // Instrucción eliminada (no se imprime)
+} IROpcode;
+
+// Tipos de operando
+typedef enum {
+    OPD_NONE,
+    OPD_VAR,        // Variable del programa (name)
+    OPD_TEMP,       // Temporal Tn (num)
+    OPD_INT,        // Literal entero (num)
+    OPD_FLOAT,      // Literal flotante (fnum)
+    OPD_STRING,     // Cadena literal (name)
+    OPD_ELEM        // Celda constante de arreglo name[num]
+} OperandKind;
+
+// Operando de una instrucción
+typedef struct {
+    OperandKind kind;
+    int num;
+    float fnum;
+    const char* name;
+    int id;         // Número de variable/arreglo (irNumberVariables)
+} Operand;
+
+// Instrucción de tres direcciones
+typedef struct {
+    IROpcode op;
+    Operand dst;
+    Operand a;
+    Operand b;
+    Operand c;      // Tercer operando (PIXEL, índice de STORE)
+    int label;      // Etiqueta de LABEL y de los saltos
+    int leader;     // 1 si inicia un bloque básico
+} IRInstr;
+
+// Bloque básico: instrucciones [start, end)
+typedef struct {
+    int start;
+    int end;
+} IRBlock;
+
+// Bucle rotado registrado por el generador: el cuerpo va de
+// LABEL bodyLabel hasta LABEL endLabel (incluye la prueba final)
+typedef struct {
+    int bodyLabel;
+    int endLabel;
+    int depth;      // 1 = bucle más externo
+    int hasCall;    // 1 si el cuerpo llama a una función (escrituras ocultas)
+} IRLoop;
+
+// Instrucción pendiente de insertar antes de code[pos]
+typedef struct {
+    int pos;
+    IRInstr ins;
+} IRInsertion;
+
+// Programa completo en memoria
+typedef struct {
+    IRInstr* code;
+    int count;
+    int capacity;
+
+    IRBlock* blocks;
+    int blockCount;
+
+    IRLoop* loops;
+    int loopCount;
+    int loopCapacity;
+
+    char** strings;     // Nombres propios (programas leídos con irParse)
+    int stringCount;
+    int stringCapacity;
+} IRProgram;
+
+// Creación y destrucción
+IRProgram* irCreate();
+void irFree(IRProgram* prog);
+
+// Constructores de operandos
+Operand opNone();
+Operand opVar(const char* name);
+Operand opTemp(int num);
+Operand opInt(int value);
+Operand opFloat(float value);
+Operand opString(const char* str);
+Operand opElem(const char* array, int index);
+
+// Emisión de instrucciones
+IRInstr* irEmit(IRProgram* prog, IROpcode op, Operand dst, Operand a, Operand b);
+IRInstr* irEmitTernary(IRProgram* prog, IROpcode op, Operand a, Operand b, Operand c);
+IRInstr* irEmitJump(IRProgram* prog, IROpcode op, Operand cond, int label);
+
+// Bucles
+void irAddLoop(IRProgram* prog, int bodyLabel, int endLabel, int depth);
+int irFindLabel(IRProgram* prog, int label);
+
+// Bloques básicos
+int irBuildBlocks(IRProgram* prog);
+int irBlockSuccessors(IRProgram* prog, int block, int* labelBlock, int succ[2]);
+int* irLabelBlockMap(IRProgram* prog, int* labelLimit);
+
+// Operandos leídos y escritos por una instrucción
+int irUses(IRInstr* ins, Operand* uses[3]);
+Operand* irDef(IRInstr* ins);
+void irCompact(IRProgram* prog);
+void irApplyInsertions(IRProgram* prog, IRInsertion* list, int count);
+
+// Serialización a texto FIS-25 y lectura de vuelta
+void irPrint(IRProgram* prog, FILE* out);
+IRProgram* irParse(FILE* in);
+
+// Utilidades
+const char* irOpcodeName(IROpcode op);
+int irIsBinary(IROpcode op);
+int irIsJump(IROpcode op);
+int irIsCompareJump(IROpcode op);
+IROpcode irCompareJumpFor(IROpcode cmp, int negate);
+int irOperandEquals(Operand x, Operand y);
+int irInstructionCount(IRProgram* prog);
+int irMaxTemp(IRProgram* prog);
+int irNumberVariables(IRProgram* prog);
+
+#endif
@@ -0,0 +1,377 @@
+/* loopopt.c - Optimizaciones de bucles sobre el código intermedio */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "loopopt.h"
+
+/*
+ * Los bucles llegan rotados desde codegen.c:
+ *
+ *       <guarda>               salta a Lend si no se entra
+ *       ...                    <- preencabezado: aquí se insertan
+ *     LABEL Lbody
+ *       cuerpo + prueba final
+ *     LABEL Lend
+ *
+ * El código antes de LABEL Lbody se ejecuta una sola vez y solo si el
+ * bucle se ejecuta, así que es el lugar para lo invariante. Los bucles
+ * se procesan del más interno al más externo: lo que sale de un bucle
+ * interno puede volver a salir del externo.
+ *
+ * Los bucles que llaman a funciones se omiten: lo que escribe la función
+ * queda fuera del rango [Lbody, Lend).
+ */
+
+typedef struct {
+    int* varStamp;      // varStamp[id] == stamp: variable escrita en el bucle
+    int* tempStamp;     // tempStamp[n] == stamp: temporal definido en el bucle
+    int* tempDefs;      // Definiciones de cada temporal en todo el programa
+    int stamp;
+} LoopState;
+
+static int isInvariant(LoopState* st, Operand* o) {
+    switch (o->kind) {
+        case OPD_INT:
+        case OPD_FLOAT:
+            return 1;
+        case OPD_VAR:
+        case OPD_ELEM:
+            return st->varStamp[o->id] != st->stamp;
+        case OPD_TEMP:
+            return st->tempStamp[o->num] != st->stamp;
+        default:
+            return 0;
+    }
+}
+
+// Solo operaciones puras que no pueden fallar al adelantarse
+static int isHoistable(LoopState* st, IRInstr* ins) {
+    if (!irIsBinary(ins->op)) return 0;
+    if (ins->dst.kind != OPD_TEMP || st->tempDefs[ins->dst.num] != 1) return 0;
+
+    if (ins->op == IR_DIV || ins->op == IR_MOD) {
+        int safe = (ins->b.kind == OPD_INT && ins->b.num != 0) ||
+                   (ins->b.kind == OPD_FLOAT && ins->b.fnum != 0.0f);
+        if (!safe) return 0;
+    }
+    return isInvariant(st, &ins->a) && isInvariant(st, &ins->b);
+}
+
+// Marca todo lo que el bucle escribe en [start, end)
+static void markWrites(IRProgram* prog, LoopState* st, int start, int end) {
+    for (int i = start; i < end; i++) {
+        IRInstr* ins = &prog->code[i];
+        if (ins->op == IR_STORE) {
+            st->varStamp[ins->b.id] = st->stamp;
+            continue;
+        }
+        Operand* def = irDef(ins);
+        if (!def) continue;
+        if (def->kind == OPD_TEMP) {
+            st->tempStamp[def->num] = st->stamp;
+        } else if (def->kind == OPD_VAR || def->kind == OPD_ELEM) {
+            st->varStamp[def->id] = st->stamp;
+        }
+    }
+}
+
+// Datos comunes a las pasadas: ids de variables, definiciones de temporales
+// y rango de etiquetas usadas por los bucles
+static int prepareState(IRProgram* prog, LoopState* st, int* labelLimit) {
+    int varCount = irNumberVariables(prog);
+    int tempLimit = irMaxTemp(prog);
+
+    st->varStamp = calloc(varCount + 1, sizeof(int));
+    st->tempStamp = calloc(tempLimit + 1, sizeof(int));
+    st->tempDefs = calloc(tempLimit + 1, sizeof(int));
+    st->stamp = 0;
+
+    for (int i = 0; i < prog->count; i++) {
+        Operand* def = irDef(&prog->code[i]);
+        if (def && def->kind == OPD_TEMP) st->tempDefs[def->num]++;
+    }
+
+    int maxDepth = 0;
+    *labelLimit = 0;
+    for (int l = 0; l < prog->loopCount; l++) {
+        IRLoop* loop = &prog->loops[l];
+        if (loop->depth > maxDepth) maxDepth = loop->depth;
+        if (loop->bodyLabel >= *labelLimit) *labelLimit = loop->bodyLabel + 1;
+        if (loop->endLabel >= *labelLimit) *labelLimit = loop->endLabel + 1;
+    }
+    return maxDepth;
+}
+
+static void freeState(LoopState* st) {
+    free(st->varStamp);
+    free(st->tempStamp);
+    free(st->tempDefs);
+}
+
+static void findLabels(IRProgram* prog, int* labelPos, int labelLimit) {
+    for (int k = 0; k < labelLimit; k++) labelPos[k] = -1;
+    for (int i = 0; i < prog->count; i++) {
+        IRInstr* ins = &prog->code[i];
+        if (ins->op == IR_LABEL && ins->label >= 0 && ins->label < labelLimit) {
+            labelPos[ins->label] = i;
+        }
+    }
+}
+
+// Lista de inserciones que crece según se necesite
+typedef struct {
+    IRInsertion* items;
+    int count;
+    int capacity;
+} InsertionList;
+
+static void addInsertion(InsertionList* list, int pos, IRInstr ins) {
+    if (list->count == list->capacity) {
+        list->capacity = list->capacity ? list->capacity * 2 : 64;
+        list->items = realloc(list->items, sizeof(IRInsertion) * list->capacity);
+    }
+    list->items[list->count].pos = pos;
+    list->items[list->count].ins = ins;
+    list->count++;
+}
+
+/* ============================================================
+   MOVIMIENTO DE CÓDIGO INVARIANTE
+   ============================================================ */
+
+int hoistLoopInvariants(IRProgram* prog) {
+    if (prog->loopCount == 0) return 0;
+
+    LoopState st;
+    int labelLimit;
+    int maxDepth = prepareState(prog, &st, &labelLimit);
+    int* labelPos = malloc(sizeof(int) * labelLimit);
+    InsertionList pending = { NULL, 0, 0 };
+    int total = 0;
+
+    for (int depth = maxDepth; depth >= 1; depth--) {
+        findLabels(prog, labelPos, labelLimit);
+        pending.count = 0;
+
+        for (int l = 0; l < prog->loopCount; l++) {
+            IRLoop* loop = &prog->loops[l];
+            if (loop->depth != depth || loop->hasCall) continue;
+            int start = labelPos[loop->bodyLabel];
+            int end = labelPos[loop->endLabel];
+            if (start < 0 || end < 0) continue;
+
+            st.stamp++;
+            markWrites(prog, &st, start, end);
+
+            for (int i = start; i < end; i++) {
+                IRInstr* ins = &prog->code[i];
+                if (!isHoistable(&st, ins)) continue;
+
+                addInsertion(&pending, start, *ins);
+                // Su resultado pasa a ser invariante para lo que sigue
+                st.tempStamp[ins->dst.num] = 0;
+                ins->op = IR_NOP;
+            }
+        }
+
+        if (pending.count > 0) {
+            irApplyInsertions(prog, pending.items, pending.count);
+            total += pending.count;
+        }
+    }
+
+    irBuildBlocks(prog);
+
+    free(labelPos);
+    free(pending.items);
+    freeState(&st);
+    return total;
+}
+
+/* ============================================================
+   REDUCCIÓN DE FUERZA
+   ============================================================ */
+
+/*
+ * Variable de inducción básica: escalar con una única escritura en el
+ * bucle de la forma i = i + c (o i - c), con c literal entero. Cada
+ * MUL i k (k literal entero) se reemplaza por una copia de un temporal
+ * s que se mantiene igual a i*k:
+ *
+ *     preencabezado:  MUL i k s
+ *     tras i = i + c: ADD s (c*k) s
+ */
+
+typedef struct {
+    int var;            // id de la variable de inducción
+    int factor;         // k
+    int temp;           // s
+} ReducedMul;
+
+// Si la escritura en code[p] es i = i +/- c, retorna 1 y el paso en step
+static int matchIncrement(IRProgram* prog, int start, int p, int* step) {
+    IRInstr* ins = &prog->code[p];
+    IRInstr* op = ins;
+    int var = ins->dst.id;
+
+    // ASSIGN Tn i: buscar la instrucción que define Tn
+    if (ins->op == IR_ASSIGN) {
+        if (ins->a.kind != OPD_TEMP) return 0;
+        op = NULL;
+        for (int q = p - 1; q >= start; q--) {
+            Operand* def = irDef(&prog->code[q]);
+            if (def && def->kind == OPD_TEMP && def->num == ins->a.num) {
+                op = &prog->code[q];
+                break;
+            }
+        }
+        if (!op) return 0;
+    }
+
+    if (op->op == IR_ADD && op->a.kind == OPD_VAR && op->a.id == var &&
+        op->b.kind == OPD_INT) {
+        *step = op->b.num;
+        return 1;
+    }
+    if (op->op == IR_ADD && op->b.kind == OPD_VAR && op->b.id == var &&
+        op->a.kind == OPD_INT) {
+        *step = op->a.num;
+        return 1;
+    }
+    if (op->op == IR_SUB && op->a.kind == OPD_VAR && op->a.id == var &&
+        op->b.kind == OPD_INT) {
+        *step = -op->b.num;
+        return 1;
+    }
+    return 0;
+}
+
+static IRInstr makeInstr(IROpcode op, Operand dst, Operand a, Operand b) {
+    IRInstr ins;
+    memset(&ins, 0, sizeof(ins));
+    ins.op = op;
+    ins.dst = dst;
+    ins.a = a;
+    ins.b = b;
+    ins.c = opNone();
+    ins.label = -1;
+    return ins;
+}
+
+int reduceInductionVariables(IRProgram* prog) {
+    if (prog->loopCount == 0) return 0;
+
+    LoopState st;
+    int labelLimit;
+    int maxDepth = prepareState(prog, &st, &labelLimit);
+    int varCount = irNumberVariables(prog);
+    int nextTemp = irMaxTemp(prog);
+
+    int* labelPos = malloc(sizeof(int) * labelLimit);
+    int* defCount = calloc(varCount + 1, sizeof(int));
+    int* defStamp = calloc(varCount + 1, sizeof(int));
+    int* defPos = malloc(sizeof(int) * (varCount + 1));
+    int* stepOf = malloc(sizeof(int) * (varCount + 1));
+    ReducedMul* reduced = NULL;
+    int reducedCapacity = 0;
+    InsertionList pending = { NULL, 0, 0 };
+    int total = 0;
+
+    for (int depth = maxDepth; depth >= 1; depth--) {
+        findLabels(prog, labelPos, labelLimit);
+        pending.count = 0;
+
+        for (int l = 0; l < prog->loopCount; l++) {
+            IRLoop* loop = &prog->loops[l];
+            if (loop->depth != depth || loop->hasCall) continue;
+            int start = labelPos[loop->bodyLabel];
+            int end = labelPos[loop->endLabel];
+            if (start < 0 || end < 0) continue;
+
+            // Contar escrituras de cada variable dentro del bucle
+            st.stamp++;
+            for (int i = start; i < end; i++) {
+                Operand* def = irDef(&prog->code[i]);
+                if (!def || def->kind != OPD_VAR) continue;
+                if (defStamp[def->id] != st.stamp) {
+                    defStamp[def->id] = st.stamp;
+                    defCount[def->id] = 0;
+                }
+                defCount[def->id]++;
+                defPos[def->id] = i;
+            }
+
+            int reducedCount = 0;
+            for (int i = start; i < end; i++) {
+                IRInstr* ins = &prog->code[i];
+                if (ins->op != IR_MUL || ins->dst.kind != OPD_TEMP) continue;
+
+                Operand* var = NULL;
+                int factor = 0;
+                if (ins->a.kind == OPD_VAR && ins->b.kind == OPD_INT) {
+                    var = &ins->a;
+                    factor = ins->b.num;
+                } else if (ins->b.kind == OPD_VAR && ins->a.kind == OPD_INT) {
+                    var = &ins->b;
+                    factor = ins->a.num;
+                } else {
+                    continue;
+                }
+
+                int id = var->id;
+                if (defStamp[id] != st.stamp || defCount[id] != 1) continue;
+                if (!matchIncrement(prog, start, defPos[id], &stepOf[id])) continue;
+
+                // Reutilizar s si ya existe para el mismo (i, k)
+                int s = -1;
+                for (int r = 0; r < reducedCount; r++) {
+                    if (reduced[r].var == id && reduced[r].factor == factor) {
+                        s = reduced[r].temp;
+                        break;
+                    }
+                }
+                if (s < 0) {
+                    s = nextTemp++;
+                    if (reducedCount == reducedCapacity) {
+                        reducedCapacity = reducedCapacity ? reducedCapacity * 2 : 16;
+                        reduced = realloc(reduced, sizeof(ReducedMul) * reducedCapacity);
+                    }
+                    reduced[reducedCount].var = id;
+                    reduced[reducedCount].factor = factor;
+                    reduced[reducedCount].temp = s;
+                    reducedCount++;
+
+                    addInsertion(&pending, start,
+                                 makeInstr(IR_VAR, opTemp(s), opNone(), opNone()));
+                    addInsertion(&pending, start,
+                                 makeInstr(IR_MUL, opTemp(s), *var, opInt(factor)));
+                    addInsertion(&pending, defPos[id] + 1,
+                                 makeInstr(IR_ADD, opTemp(s), opTemp(s),
+                                           opInt(stepOf[id] * factor)));
+                }
+
+                // MUL i k Tx  ->  ASSIGN s Tx
+                ins->op = IR_ASSIGN;
+                ins->a = opTemp(s);
+                ins->b = opNone();
+                total++;
+            }
+        }
+
+        if (pending.count > 0) {
+            irApplyInsertions(prog, pending.items, pending.count);
+        }
+    }
+
+    irBuildBlocks(prog);
+
+    free(labelPos);
+    free(defCount);
+    free(defStamp);
+    free(defPos);
+    free(stepOf);
+    free(reduced);
+    free(pending.items);
+    freeState(&st);
+    return total;
+}
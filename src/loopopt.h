@@ -0,0 +1,15 @@
+/* loopopt.h - Optimizaciones de bucles sobre el código intermedio */
+#ifndef LOOPOPT_H
+#define LOOPOPT_H
+
+#include "ir.h"
+
+// Mueve al preencabezado los cálculos invariantes de cada bucle.
+// Retorna la cantidad de instrucciones movidas.
+int hoistLoopInvariants(IRProgram* prog);
+
+// Reemplaza multiplicaciones por variables de inducción con sumas
+// incrementales. Retorna la cantidad de MUL eliminados del bucle.
+int reduceInductionVariables(IRProgram* prog);
+
+#endif
@@ -7,6 +7,15 @@
 #include "symtable.h"
 #include "semantic.h"
 #include "codegen.h"
+#include "regalloc.h"
+#include "constfold.h"
+#include "inline.h"
+#include "unroll.h"
+#include "loopopt.h"
+#include "deadcode.h"
+#include "cse.h"
+#include "peephole.h"
+#include "stats.h"
 
 // Declaraciones externas de Bison/Flex
 extern FILE* yyin;
@@ -19,6 +28,11 @@ typedef struct {
     int verbose;
     int printAST;
     int skipSemantic;
+    int optimize;
+    int peepholeOnly;
+    int unrollBudget;
+    int stats;
+    char* statsJsonFile;
     char* inputFile;
     char* outputFile;
 } CompilerOptions;
@@ -30,6 +44,12 @@ void printUsage(char* progName) {
     printf("  -v             Modo verbose (muestra detalles)\n");
     printf("  -a             Imprime el AST generado\n");
     printf("  -s             Omite análisis semántico\n");
+    printf("  -O0            Desactiva las optimizaciones del código intermedio\n");
+    printf("  -u <nodos>     Presupuesto para desenrollar bucles (default: %d, 0 desactiva)\n",
+           UNROLL_DEFAULT_BUDGET);
+    printf("  -P             Optimiza un archivo .fis25 ya generado (mirilla)\n");
+    printf("  --stats        Reporta tiempo y memoria por fase y tamaños del programa\n");
+    printf("  --stats-json <archivo>  Escribe el mismo reporte en JSON\n");
     printf("  -h             Muestra esta ayuda\n");
 }
 
@@ -38,8 +58,13 @@ void parseArguments(int argc, char** argv, CompilerOptions* opts) {
     opts->verbose = 0;
     opts->printAST = 0;
     opts->skipSemantic = 0;
+    opts->optimize = 1;
+    opts->peepholeOnly = 0;
+    opts->unrollBudget = UNROLL_DEFAULT_BUDGET;
+    opts->stats = 0;
+    opts->statsJsonFile = NULL;
     opts->inputFile = NULL;
-    opts->outputFile = "salida.fis25";
+    opts->outputFile = NULL;
     
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "-v") == 0) {
@@ -48,9 +73,29 @@ void parseArguments(int argc, char** argv, CompilerOptions* opts) {
             opts->printAST = 1;
         } else if (strcmp(argv[i], "-s") == 0) {
             opts->skipSemantic = 1;
+        } else if (strcmp(argv[i], "-O0") == 0) {
+            opts->optimize = 0;
+        } else if (strcmp(argv[i], "-P") == 0) {
+            opts->peepholeOnly = 1;
         } else if (strcmp(argv[i], "-h") == 0) {
             printUsage(argv[0]);
             exit(0);
+        } else if (strcmp(argv[i], "-u") == 0) {
+            if (i + 1 < argc) {
+                opts->unrollBudget = atoi(argv[++i]);
+            } else {
+                fprintf(stderr, "Error: -u requiere un número de nodos\n");
+                exit(1);
+            }
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            opts->stats = 1;
+        } else if (strcmp(argv[i], "--stats-json") == 0) {
+            if (i + 1 < argc) {
+                opts->statsJsonFile = argv[++i];
+            } else {
+                fprintf(stderr, "Error: --stats-json requiere un nombre de archivo\n");
+                exit(1);
+            }
         } else if (strcmp(argv[i], "-o") == 0) {
             if (i + 1 < argc) {
                 opts->outputFile = argv[++i];
@@ -72,6 +117,45 @@ void parseArguments(int argc, char** argv, CompilerOptions* opts) {
         printUsage(argv[0]);
         exit(1);
     }
+    
+    // En modo mirilla el archivo se reescribe salvo que se indique -o
+    if (!opts->outputFile) {
+        opts->outputFile = opts->peepholeOnly ? opts->inputFile : "salida.fis25";
+    }
+}
+
+// Modo mirilla: lee un .fis25, lo optimiza y lo vuelve a escribir
+int runPeephole(CompilerOptions* opts) {
+    FILE* input = fopen(opts->inputFile, "r");
+    if (!input) {
+        fprintf(stderr, "❌ Error: No se pudo abrir '%s'\n", opts->inputFile);
+        return 1;
+    }
+    IRProgram* program = irParse(input);
+    fclose(input);
+    if (!program) {
+        fprintf(stderr, "❌ Error: '%s' no es un programa FIS-25 válido\n", opts->inputFile);
+        return 1;
+    }
+    
+    int before = irInstructionCount(program);
+    PeepholeStats stats = optimizePeephole(program);
+    
+    FILE* output = fopen(opts->outputFile, "w");
+    if (!output) {
+        fprintf(stderr, "❌ Error: No se pudo crear '%s'\n", opts->outputFile);
+        irFree(program);
+        return 1;
+    }
+    irPrint(program, output);
+    fclose(output);
+    
+    printf("✅ Mirilla: %d reglas aplicadas en %d pasadas\n", stats.rewrites, stats.passes);
+    printf("   Instrucciones: %d -> %d\n", before, irInstructionCount(program));
+    printf("📄 Archivo de salida: %s\n", opts->outputFile);
+    
+    irFree(program);
+    return 0;
 }
 
 int main(int argc, char** argv) {
@@ -83,6 +167,10 @@ int main(int argc, char** argv) {
     printf("║   Proyecto de Compiladores 2025        ║\n");
     printf("╚════════════════════════════════════════╝\n\n");
     
+    if (opts.peepholeOnly) {
+        return runPeephole(&opts);
+    }
+    
     // ========== FASE 1: ANÁLISIS LÉXICO Y SINTÁCTICO ==========
     if (opts.verbose) {
         printf("🔍 Fase 1: Análisis Léxico y Sintáctico\n");
@@ -95,7 +183,9 @@ int main(int argc, char** argv) {
         return 1;
     }
     
+    statsBegin("léxico y sintáctico");
     int parseResult = yyparse();
+    statsEnd();
     fclose(yyin);
     
     if (parseResult != 0) {
@@ -110,6 +200,23 @@ int main(int argc, char** argv) {
     
     printf("✅ Análisis sintáctico completado\n\n");
     
+    // Tamaño del árbol antes de que las optimizaciones lo cambien
+    CompileCounters counters = { 0 };
+    int wantStats = opts.stats || opts.statsJsonFile;
+    if (wantStats) {
+        counters.lines = yylineno - 1;     // Saltos de línea, como wc -l
+        counters.nodes = countNodes(root);
+        counters.depth = treeDepth(root);
+        counters.astBytes = astArenaBytes();
+    }
+
+    if (opts.verbose) {
+        int nodes = countNodes(root);
+        size_t bytes = astArenaBytes();
+        printf("   Nodos del AST: %d (%zu bytes de nodo, %.1f bytes por nodo con cadenas)\n\n",
+               nodes, sizeof(ASTNode), nodes ? (double)bytes / nodes : 0.0);
+    }
+    
     // Imprimir AST si se solicita
     if (opts.printAST) {
         printf("🌳 Árbol de Sintaxis Abstracta:\n");
@@ -124,10 +231,13 @@ int main(int argc, char** argv) {
         }
         
         // Inicializar tabla de símbolos
+        statsBegin("semántico");
         initSymbolTable();
         
         // Verificar tipos y semántica
-        if (!checkSemantics(root)) {
+        int semanticOk = checkSemantics(root);
+        statsEnd();
+        if (!semanticOk) {
             fprintf(stderr, "❌ Errores semánticos encontrados\n");
             return 1;
         }
@@ -146,27 +256,102 @@ int main(int argc, char** argv) {
         printf("🔍 Fase 3: Generación de Código Intermedio\n");
     }
     
-    // Redirigir salida a archivo
+    // Expansión en línea, plegado y propagación de constantes sobre el AST
+    if (opts.optimize) {
+        statsBegin("expansión en línea");
+        int inlined = inlineFunctions(root);
+        statsEnd();
+        if (opts.verbose) {
+            printf("   Llamadas expandidas en línea: %d\n", inlined);
+        }
+        
+        statsBegin("plegado de constantes");
+        FoldStats foldStats = foldConstants(root);
+        statsEnd();
+        if (opts.verbose) {
+            printf("   Constantes plegadas: %d, propagadas: %d\n",
+                   foldStats.folded, foldStats.propagated);
+        }
+        
+        // Las copias del cuerpo quedan con índices literales: volver a plegar
+        statsBegin("desenrollado");
+        UnrollStats unrollStats = unrollLoops(root, opts.unrollBudget);
+        if (unrollStats.full + unrollStats.partial > 0) {
+            foldConstants(root);
+        }
+        statsEnd();
+        if (opts.verbose) {
+            printf("   Bucles desenrollados: %d completos, %d parciales\n",
+                   unrollStats.full, unrollStats.partial);
+        }
+    }
+    
+    // Construir el código intermedio en memoria
+    statsBegin("generación de código");
+    IRProgram* program = generateIR(root);
+    statsEnd();
+    
+    // ========== FASE 4: OPTIMIZACIÓN ==========
+    TempAllocStats tempStats = { getTempCount(), getTempCount() };
+    if (opts.optimize) {
+        if (opts.verbose) {
+            printf("🔍 Fase 4: Optimización del código intermedio\n");
+        }
+        
+        statsBegin("subexpresiones comunes");
+        int common = eliminateCommonSubexpressions(program);
+        statsEnd();
+        statsBegin("invariantes de bucle");
+        int hoisted = hoistLoopInvariants(program);
+        statsEnd();
+        statsBegin("reducción de fuerza");
+        int reduced = reduceInductionVariables(program);
+        statsEnd();
+        statsBegin("código muerto");
+        DeadCodeStats deadStats = eliminateDeadCode(program);
+        statsEnd();
+        statsBegin("mirilla");
+        PeepholeStats peepStats = optimizePeephole(program);
+        statsEnd();
+        statsBegin("temporales");
+        tempStats = allocateTemps(program);
+        statsEnd();
+        
+        if (opts.verbose) {
+            printf("   Subexpresiones comunes reutilizadas: %d\n", common);
+            printf("   Invariantes movidos fuera de bucles: %d\n", hoisted);
+            printf("   Multiplicaciones reducidas a sumas: %d\n", reduced);
+            printf("   Código inalcanzable eliminado: %d instrucciones\n",
+                   deadStats.unreachable);
+            printf("   Escrituras muertas eliminadas: %d\n", deadStats.deadStores);
+            printf("   Declaraciones sin uso eliminadas: %d\n", deadStats.unusedVars);
+            printf("   Mirilla: %d reglas aplicadas en %d pasadas\n",
+                   peepStats.rewrites, peepStats.passes);
+            printf("   Temporales: %d -> %d celdas\n",
+                   tempStats.tempsBefore, tempStats.slotsAfter);
+        }
+    }
+    
+    // Escribir el programa en el archivo de salida
     FILE* output = fopen(opts.outputFile, "w");
     if (!output) {
         fprintf(stderr, "❌ Error: No se pudo crear '%s'\n", opts.outputFile);
         return 1;
     }
     
-    // Redirigir stdout temporalmente
-    FILE* oldStdout = stdout;
-    stdout = output;
+    fprintf(output, "// Compilador FIS-25\n");
+    fprintf(output, "// Archivo fuente: %s\n", opts.inputFile);
+    fprintf(output, "// Generado automáticamente\n\n");
     
-    // Generar código FIS-25
-    printf("// Compilador FIS-25\n");
-    printf("// Archivo fuente: %s\n", opts.inputFile);
-    printf("// Generado automáticamente\n\n");
-    
-    generateCode(root);
-    
-    // Restaurar stdout
-    stdout = oldStdout;
+    statsBegin("escritura");
+    irPrint(program, output);
     fclose(output);
+    statsEnd();
+    
+    if (opts.verbose) {
+        printf("   Instrucciones: %d\n", irInstructionCount(program));
+        printf("   Bloques básicos: %d\n", program->blockCount);
+    }
     
     printf("✅ Código generado: %s\n\n", opts.outputFile);
     
@@ -177,6 +362,30 @@ int main(int argc, char** argv) {
     printf("📄 Archivo de salida: %s\n", opts.outputFile);
     printf("📊 Variables declaradas: %d\n", getSymbolCount());
     printf("🏷️  Etiquetas generadas: %d\n", getLabelCount());
+    printf("🧮 Celdas temporales: %d (de %d temporales)\n",
+           tempStats.slotsAfter, tempStats.tempsBefore);
+    
+    if (wantStats) {
+        counters.symbols = getSymbolCount();
+        counters.temps = tempStats.tempsBefore;
+        counters.tempSlots = tempStats.slotsAfter;
+        counters.labels = getLabelCount();
+        counters.instructions = irInstructionCount(program);
+    }
+    if (opts.stats) {
+        statsPrint(stdout, &counters);
+    }
+    if (opts.statsJsonFile) {
+        FILE* json = fopen(opts.statsJsonFile, "w");
+        if (!json) {
+            fprintf(stderr, "❌ Error: No se pudo crear '%s'\n", opts.statsJsonFile);
+            return 1;
+        }
+        statsPrintJSON(json, opts.inputFile, &counters);
+        fclose(json);
+    }
     
+    irFree(program);
+    freeASTArena();
     return 0;
 }
\ No newline at end of file
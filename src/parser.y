@@ -22,7 +22,7 @@ ASTNode* root = NULL;
 
 %token <intValue> NUMBER BOOL_VAL
 %token <floatValue> FLOAT_NUM
-%token <idName> ID STRING_LIT
+%token <idName> ID FUNC_ID STRING_LIT
 
 %token TYPE_INT TYPE_FLOAT TYPE_BOOL TYPE_STRING
 %token KW_PIXEL KW_KEY KW_INPUT KW_PRINT
@@ -51,8 +51,10 @@ ASTNode* root = NULL;
 %nonassoc KW_ELSE
 
 %type <node> program stmt_list stmt block
+%type <node> function param_list params arg_list args
 %type <node> expr logical_or logical_and comparison additive multiplicative unary primary
 %type <intValue> type
+%type <idName> function_name callee
 
 %%
 
@@ -73,6 +75,63 @@ type:
     | TYPE_STRING { $$ = TYPE_STRING_T; }
     ;
 
+/* Definición de función: function [tipo] nombre(parámetros) { ... } */
+function:
+    KW_FUNCTION type function_name LPAREN param_list RPAREN block
+    {
+        $$ = newFunction($2, $3, $5, $7);
+        qualifyLocals($$);
+    }
+    | KW_FUNCTION function_name LPAREN param_list RPAREN block
+    {
+        $$ = newFunction(TYPE_VOID_T, $2, $4, $6);
+        qualifyLocals($$);
+    }
+    ;
+
+/* Desde aquí el lexer entrega el nombre como FUNC_ID. Una redefinición
+   llega como FUNC_ID y la reporta el análisis semántico. */
+function_name:
+    ID { markFunctionName($1); $$ = $1; }
+    | FUNC_ID { $$ = $1; }
+    ;
+
+/* Como sentencia, "nombre (" no es ambiguo: una función aún no definida
+   llega como ID y la reporta el análisis semántico */
+callee:
+    ID { $$ = $1; }
+    | FUNC_ID { $$ = $1; }
+    ;
+
+param_list:
+    params { $$ = $1; }
+    | /* vacío */ { $$ = NULL; }
+    ;
+
+params:
+    type ID
+    {
+        $$ = newId($2);
+        $$->varType = $1;
+    }
+    | params COMMA type ID
+    {
+        ASTNode* param = newId($4);
+        param->varType = $3;
+        $$ = appendNext($1, param);
+    }
+    ;
+
+arg_list:
+    args { $$ = $1; }
+    | /* vacío */ { $$ = NULL; }
+    ;
+
+args:
+    expr { $$ = $1; }
+    | args COMMA expr { $$ = appendNext($1, $3); }
+    ;
+
 block:
     LBRACE stmt_list RBRACE { $$ = newBlock($2); }
     | LBRACE RBRACE { $$ = NULL; }
@@ -98,9 +157,16 @@ stmt:
     | ID LBRACKET expr RBRACKET ASSIGN expr SEMI 
     { 
         $$ = newAssign($1, $6);
-        $$->index = $3;
+        AST_INDEX($$) = $3;
     }
     
+    /* Llamada a función como sentencia */
+    | callee LPAREN arg_list RPAREN SEMI
+    { $$ = newCall($1, $3); }
+    
+    /* Definición de función */
+    | function { $$ = $1; }
+    
     /* PIXEL */
     | KW_PIXEL expr expr expr SEMI 
     { $$ = newPixel($2, $3, $4); }
@@ -194,10 +260,12 @@ primary:
     | BOOL_VAL { $$ = newBool($1); }
     | ID { $$ = newId($1); }
     | ID LBRACKET expr RBRACKET { $$ = newArrayAccess($1, $3); }
+    /* Solo un nombre de función ya definida seguido de ( es una llamada:
+       en PIXEL a (b) c, si a es una variable, (b) es el segundo operando */
+    | FUNC_ID LPAREN arg_list RPAREN { $$ = newCall($1, $3); }
     | ID DOT ID { 
         if (strcmp($3, "length") == 0) {
             $$ = newArrayLength($1);
-            free($3);
         } else {
             yyerror("Propiedad no reconocida");
             $$ = newInt(0);
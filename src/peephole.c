@@ -0,0 +1,452 @@
+/* peephole.c - Optimizaciones de mirilla sobre el código FIS-25 */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "peephole.h"
+
+/*
+ * Cada regla mira una ventana corta que empieza en una instrucción y,
+ * si la reconoce, la reescribe en el lugar (las instrucciones borradas
+ * quedan como NOP). La tabla se recorre sobre todo el programa hasta que
+ * una pasada completa no cambia nada.
+ *
+ * Muchas reglas eliminan un temporal intermedio; solo se aplican si ese
+ * temporal está muerto después de la ventana. Como el código puede venir
+ * de un archivo .fis25 con temporales ya reutilizados, eso se comprueba
+ * por conteo de usos o mirando hacia adelante dentro del bloque.
+ */
+
+#define MAX_PASSES 64
+#define MAX_THREAD_HOPS 16
+
+typedef struct {
+    IRProgram* prog;
+    int* tempUses;      // Lecturas de cada temporal
+    int* tempDefs;      // Escrituras de cada temporal
+    int tempLimit;
+    int* labelRefs;     // Saltos que apuntan a cada etiqueta
+    int* labelPos;      // Posición de cada LABEL
+    int labelLimit;
+} PeepState;
+
+typedef int (*PeepRule)(PeepState* st, int i);
+
+/* ============================================================
+   AUXILIARES
+   ============================================================ */
+
+static int isSkipped(IRInstr* ins) {
+    return ins->op == IR_NOP || ins->op == IR_COMMENT;
+}
+
+// Siguiente instrucción real después de i (-1 si no hay)
+static int nextInstr(PeepState* st, int i) {
+    for (int j = i + 1; j < st->prog->count; j++) {
+        if (!isSkipped(&st->prog->code[j])) return j;
+    }
+    return -1;
+}
+
+static void countRefs(PeepState* st, IRInstr* ins, int delta) {
+    Operand* uses[3];
+    int n = irUses(ins, uses);
+    for (int k = 0; k < n; k++) {
+        if (uses[k]->kind == OPD_TEMP) st->tempUses[uses[k]->num] += delta;
+    }
+    Operand* def = irDef(ins);
+    if (def && def->kind == OPD_TEMP) st->tempDefs[def->num] += delta;
+    if (irIsJump(ins->op) && ins->label >= 0 && ins->label < st->labelLimit) {
+        st->labelRefs[ins->label] += delta;
+    }
+}
+
+static void removeInstr(PeepState* st, int i) {
+    countRefs(st, &st->prog->code[i], -1);
+    st->prog->code[i].op = IR_NOP;
+}
+
+// Reemplaza code[i] por ins manteniendo los conteos al día
+static void replaceInstr(PeepState* st, int i, IRInstr ins) {
+    countRefs(st, &st->prog->code[i], -1);
+    ins.leader = 0;
+    st->prog->code[i] = ins;
+    countRefs(st, &st->prog->code[i], 1);
+}
+
+static int usesTemp(IRInstr* ins, int t) {
+    Operand* uses[3];
+    int n = irUses(ins, uses);
+    for (int k = 0; k < n; k++) {
+        if (uses[k]->kind == OPD_TEMP && uses[k]->num == t) return 1;
+    }
+    return 0;
+}
+
+static int definesTemp(IRInstr* ins, int t) {
+    Operand* def = irDef(ins);
+    return def && def->kind == OPD_TEMP && def->num == t;
+}
+
+// 1 si el temporal t no se vuelve a leer después de code[i], suponiendo
+// que las lecturas en la ventana que se reescribe ya se descontaron
+static int tempDeadAfter(PeepState* st, int i, int t) {
+    if (st->tempUses[t] == 0) return 1;
+    for (int j = i + 1; j < st->prog->count; j++) {
+        IRInstr* ins = &st->prog->code[j];
+        if (isSkipped(ins)) continue;
+        if (usesTemp(ins, t)) return 0;
+        if (definesTemp(ins, t)) return 1;
+        if (ins->op == IR_RETURN) return 1;
+        if (ins->op == IR_LABEL || irIsJump(ins->op)) return 0;
+    }
+    return 1;
+}
+
+// Cuántas lecturas de t hay en la instrucción
+static int tempReadCount(IRInstr* ins, int t) {
+    Operand* uses[3];
+    int n = irUses(ins, uses);
+    int count = 0;
+    for (int k = 0; k < n; k++) {
+        if (uses[k]->kind == OPD_TEMP && uses[k]->num == t) count++;
+    }
+    return count;
+}
+
+// 1 si el valor recién escrito en t solo se lee en code[j]
+static int consumedBy(PeepState* st, int j, int t) {
+    int reads = tempReadCount(&st->prog->code[j], t);
+    if (reads == 0) return 0;
+    if (st->tempUses[t] == reads && st->tempDefs[t] == 1) return 1;
+
+    // Código con temporales reutilizados: mirar hacia adelante
+    st->tempUses[t] -= reads;
+    int dead = definesTemp(&st->prog->code[j], t) || tempDeadAfter(st, j, t);
+    st->tempUses[t] += reads;
+    return dead;
+}
+
+static int isIntLiteral(Operand* o, int value) {
+    return o->kind == OPD_INT && o->num == value;
+}
+
+static int isComparison(IROpcode op) {
+    return op >= IR_EQ && op <= IR_GTE;
+}
+
+static IROpcode negateComparison(IROpcode op) {
+    switch (op) {
+        case IR_EQ:  return IR_NEQ;
+        case IR_NEQ: return IR_EQ;
+        case IR_LT:  return IR_GTE;
+        case IR_GT:  return IR_LTE;
+        case IR_LTE: return IR_GT;
+        case IR_GTE: return IR_LT;
+        default:     return op;
+    }
+}
+
+/* ============================================================
+   REGLAS
+   ============================================================ */
+
+// Salto a una etiqueta que viene justo después: GOTO Lx / LABEL Lx
+static int jumpToNext(PeepState* st, int i) {
+    IRInstr* ins = &st->prog->code[i];
+    if (!irIsJump(ins->op)) return 0;
+    for (int j = nextInstr(st, i); j >= 0; j = nextInstr(st, j)) {
+        IRInstr* next = &st->prog->code[j];
+        if (next->op != IR_LABEL) return 0;
+        if (next->label == ins->label) {
+            removeInstr(st, i);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Salto a un GOTO: apuntar directamente al destino final
+static int threadJump(PeepState* st, int i) {
+    IRInstr* ins = &st->prog->code[i];
+    if (!irIsJump(ins->op)) return 0;
+
+    int target = ins->label;
+    for (int hop = 0; hop < MAX_THREAD_HOPS; hop++) {
+        if (target < 0 || target >= st->labelLimit || st->labelPos[target] < 0) break;
+        int j = nextInstr(st, st->labelPos[target]);
+        if (j < 0 || st->prog->code[j].op != IR_GOTO) break;
+        if (st->prog->code[j].label == target) break;
+        target = st->prog->code[j].label;
+        if (target == ins->label) return 0;    // Ciclo de GOTOs
+    }
+    if (target == ins->label) return 0;
+
+    IRInstr updated = *ins;
+    updated.label = target;
+    replaceInstr(st, i, updated);
+    return 1;
+}
+
+// Código después de GOTO o RETURN hasta la próxima etiqueta
+static int dropAfterJump(PeepState* st, int i) {
+    IROpcode op = st->prog->code[i].op;
+    if (op != IR_GOTO && op != IR_RETURN) return 0;
+    int j = nextInstr(st, i);
+    if (j < 0) return 0;
+    IROpcode next = st->prog->code[j].op;
+    if (next == IR_LABEL || next == IR_VAR) return 0;
+    removeInstr(st, j);
+    return 1;
+}
+
+// ADD a 0 t, SUB a 0 t, MUL a 1 t, DIV a 1 t (y simétricos) -> ASSIGN a t
+static int arithmeticIdentity(PeepState* st, int i) {
+    IRInstr* ins = &st->prog->code[i];
+    Operand* keep = NULL;
+    switch (ins->op) {
+        case IR_ADD:
+            if (isIntLiteral(&ins->b, 0)) keep = &ins->a;
+            else if (isIntLiteral(&ins->a, 0)) keep = &ins->b;
+            break;
+        case IR_MUL:
+            if (isIntLiteral(&ins->b, 1)) keep = &ins->a;
+            else if (isIntLiteral(&ins->a, 1)) keep = &ins->b;
+            break;
+        case IR_SUB:
+        case IR_DIV:
+            if (isIntLiteral(&ins->b, ins->op == IR_SUB ? 0 : 1)) keep = &ins->a;
+            break;
+        default:
+            break;
+    }
+    if (!keep) return 0;
+
+    IRInstr updated = *ins;
+    updated.op = IR_ASSIGN;
+    updated.a = *keep;
+    updated.b = opNone();
+    replaceInstr(st, i, updated);
+    return 1;
+}
+
+// ASSIGN x x
+static int selfAssign(PeepState* st, int i) {
+    IRInstr* ins = &st->prog->code[i];
+    if (ins->op != IR_ASSIGN) return 0;
+    if (ins->dst.kind != OPD_VAR && ins->dst.kind != OPD_TEMP) return 0;
+    if (!irOperandEquals(ins->a, ins->dst)) return 0;
+    removeInstr(st, i);
+    return 1;
+}
+
+// OP a b t / ASSIGN t x  ->  OP a b x
+static int foldCopyIntoOp(PeepState* st, int i) {
+    IRInstr* ins = &st->prog->code[i];
+    if (!irIsBinary(ins->op) && ins->op != IR_LOAD && ins->op != IR_ASSIGN) return 0;
+    if (ins->dst.kind != OPD_TEMP) return 0;
+
+    int j = nextInstr(st, i);
+    if (j < 0) return 0;
+    IRInstr* copy = &st->prog->code[j];
+    if (copy->op != IR_ASSIGN || copy->a.kind != OPD_TEMP || copy->a.num != ins->dst.num) return 0;
+    if (copy->dst.kind != OPD_VAR && copy->dst.kind != OPD_TEMP) return 0;
+    if (!consumedBy(st, j, ins->dst.num)) return 0;
+
+    IRInstr updated = *ins;
+    updated.dst = copy->dst;
+    removeInstr(st, j);
+    replaceInstr(st, i, updated);
+    return 1;
+}
+
+// ASSIGN a t / X ... t ...  ->  X ... a ...
+static int propagateCopy(PeepState* st, int i) {
+    IRInstr* ins = &st->prog->code[i];
+    if (ins->op != IR_ASSIGN || ins->dst.kind != OPD_TEMP) return 0;
+    OperandKind kind = ins->a.kind;
+    if (kind != OPD_VAR && kind != OPD_TEMP && kind != OPD_INT && kind != OPD_FLOAT) return 0;
+
+    int j = nextInstr(st, i);
+    if (j < 0) return 0;
+    IRInstr* user = &st->prog->code[j];
+    int literal = (kind == OPD_INT || kind == OPD_FLOAT);
+    if (literal && (user->op == IR_IFFALSE || user->op == IR_IFTRUE)) return 0;
+    int t = ins->dst.num;
+    if (!consumedBy(st, j, t)) return 0;
+
+    IRInstr updated = *user;
+    Operand* uses[3];
+    int n = irUses(&updated, uses);
+    for (int k = 0; k < n; k++) {
+        if (uses[k]->kind == OPD_TEMP && uses[k]->num == t) *uses[k] = ins->a;
+    }
+    removeInstr(st, i);
+    replaceInstr(st, j, updated);
+    return 1;
+}
+
+// CMP a b t / EQ t 0 u  ->  !CMP a b u   (doble NOT y negación de comparación)
+// CMP a b t / NEQ t 0 u ->  CMP a b u
+static int foldNegation(PeepState* st, int i) {
+    IRInstr* ins = &st->prog->code[i];
+    if (!isComparison(ins->op) || ins->dst.kind != OPD_TEMP) return 0;
+
+    int j = nextInstr(st, i);
+    if (j < 0) return 0;
+    IRInstr* test = &st->prog->code[j];
+    if (test->op != IR_EQ && test->op != IR_NEQ) return 0;
+    int t = ins->dst.num;
+    int matches = (test->a.kind == OPD_TEMP && test->a.num == t && isIntLiteral(&test->b, 0)) ||
+                  (test->b.kind == OPD_TEMP && test->b.num == t && isIntLiteral(&test->a, 0));
+    if (!matches || !consumedBy(st, j, t)) return 0;
+
+    IRInstr updated = *ins;
+    updated.op = test->op == IR_EQ ? negateComparison(ins->op) : ins->op;
+    updated.dst = test->dst;
+    removeInstr(st, j);
+    replaceInstr(st, i, updated);
+    return 1;
+}
+
+// SUB 0 x t / SUB a t u  ->  ADD a x u
+// SUB 0 x t / ADD a t u  ->  SUB a x u
+static int foldUnaryMinus(PeepState* st, int i) {
+    IRInstr* ins = &st->prog->code[i];
+    if (ins->op != IR_SUB || !isIntLiteral(&ins->a, 0) || ins->dst.kind != OPD_TEMP) return 0;
+
+    int j = nextInstr(st, i);
+    if (j < 0) return 0;
+    IRInstr* user = &st->prog->code[j];
+    int t = ins->dst.num;
+    int tInB = user->b.kind == OPD_TEMP && user->b.num == t;
+    int tInA = user->a.kind == OPD_TEMP && user->a.num == t;
+
+    IRInstr updated = *user;
+    if (user->op == IR_SUB && tInB && !tInA) {
+        updated.op = IR_ADD;
+        updated.b = ins->b;
+    } else if (user->op == IR_ADD && tInB != tInA) {
+        updated.op = IR_SUB;
+        updated.a = tInA ? user->b : user->a;
+        updated.b = ins->b;
+    } else {
+        return 0;
+    }
+    if (!consumedBy(st, j, t)) return 0;
+
+    removeInstr(st, i);
+    replaceInstr(st, j, updated);
+    return 1;
+}
+
+// CMP a b t / IFFALSE t GOTO L  ->  IF!CMP a b GOTO L
+static int fuseCompareJump(PeepState* st, int i) {
+    IRInstr* ins = &st->prog->code[i];
+    if (!isComparison(ins->op) || ins->dst.kind != OPD_TEMP) return 0;
+
+    int j = nextInstr(st, i);
+    if (j < 0) return 0;
+    IRInstr* jump = &st->prog->code[j];
+    if (jump->op != IR_IFFALSE && jump->op != IR_IFTRUE) return 0;
+    if (jump->a.kind != OPD_TEMP || jump->a.num != ins->dst.num) return 0;
+    if (!consumedBy(st, j, ins->dst.num)) return 0;
+
+    IRInstr updated = *jump;
+    updated.op = irCompareJumpFor(ins->op, jump->op == IR_IFFALSE);
+    updated.a = ins->a;
+    updated.b = ins->b;
+    removeInstr(st, i);
+    replaceInstr(st, j, updated);
+    return 1;
+}
+
+// Etiqueta a la que ningún salto apunta
+static int unusedLabel(PeepState* st, int i) {
+    IRInstr* ins = &st->prog->code[i];
+    if (ins->op != IR_LABEL) return 0;
+    if (ins->label >= 0 && ins->label < st->labelLimit && st->labelRefs[ins->label] > 0) return 0;
+    removeInstr(st, i);
+    return 1;
+}
+
+static const struct {
+    const char* name;
+    PeepRule apply;
+} rules[] = {
+    { "salto a la siguiente instrucción", jumpToNext },
+    { "salto a salto", threadJump },
+    { "código tras GOTO o RETURN", dropAfterJump },
+    { "identidad aritmética", arithmeticIdentity },
+    { "copia a sí mismo", selfAssign },
+    { "resultado copiado", foldCopyIntoOp },
+    { "propagación de copia", propagateCopy },
+    { "negación de comparación", foldNegation },
+    { "menos unario", foldUnaryMinus },
+    { "comparación y salto", fuseCompareJump },
+    { "etiqueta sin uso", unusedLabel },
+};
+
+#define RULE_COUNT ((int)(sizeof(rules) / sizeof(rules[0])))
+
+/* ============================================================
+   RECORRIDO
+   ============================================================ */
+
+static void prepareState(PeepState* st) {
+    IRProgram* prog = st->prog;
+    st->tempLimit = irMaxTemp(prog);
+    st->labelLimit = 0;
+    for (int i = 0; i < prog->count; i++) {
+        if (prog->code[i].label >= st->labelLimit) st->labelLimit = prog->code[i].label + 1;
+    }
+
+    st->tempUses = calloc(st->tempLimit + 1, sizeof(int));
+    st->tempDefs = calloc(st->tempLimit + 1, sizeof(int));
+    st->labelRefs = calloc(st->labelLimit + 1, sizeof(int));
+    st->labelPos = malloc(sizeof(int) * (st->labelLimit + 1));
+    for (int l = 0; l < st->labelLimit; l++) st->labelPos[l] = -1;
+
+    for (int i = 0; i < prog->count; i++) {
+        IRInstr* ins = &prog->code[i];
+        countRefs(st, ins, 1);
+        if (ins->op == IR_LABEL && ins->label >= 0) st->labelPos[ins->label] = i;
+    }
+}
+
+static void freeState(PeepState* st) {
+    free(st->tempUses);
+    free(st->tempDefs);
+    free(st->labelRefs);
+    free(st->labelPos);
+}
+
+PeepholeStats optimizePeephole(IRProgram* prog) {
+    PeepholeStats stats = { 0, 0 };
+
+    int changed = 1;
+    while (changed && stats.passes < MAX_PASSES) {
+        changed = 0;
+        stats.passes++;
+
+        PeepState st;
+        st.prog = prog;
+        prepareState(&st);
+
+        for (int i = 0; i < prog->count; i++) {
+            if (isSkipped(&prog->code[i])) continue;
+            for (int r = 0; r < RULE_COUNT; r++) {
+                if (rules[r].apply(&st, i)) {
+                    stats.rewrites++;
+                    changed = 1;
+                    if (isSkipped(&prog->code[i])) break;
+                }
+            }
+        }
+
+        freeState(&st);
+        irCompact(prog);
+    }
+
+    irBuildBlocks(prog);
+    return stats;
+}
@@ -0,0 +1,16 @@
+/* peephole.h - Optimizaciones de mirilla sobre el código FIS-25 */
+#ifndef PEEPHOLE_H
+#define PEEPHOLE_H
+
+#include "ir.h"
+
+// Resultado de la optimización de mirilla
+typedef struct {
+    int rewrites;       // Reglas aplicadas
+    int passes;         // Pasadas hasta el punto fijo
+} PeepholeStats;
+
+// Aplica la tabla de reglas hasta que ninguna cambie el programa
+PeepholeStats optimizePeephole(IRProgram* prog);
+
+#endif
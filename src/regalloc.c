@@ -0,0 +1,305 @@
+/* regalloc.c - Reutilización de temporales por análisis de vida */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "regalloc.h"
+
+/*
+ * Cada temporal recibe un intervalo de vida sobre el orden lineal del
+ * código, medido en medios pasos: la lectura en la instrucción p es el
+ * punto 2p y la escritura es 2p+1. Así un temporal que muere en p puede
+ * compartir celda con el que se define en p (ADD T1 x T1).
+ *
+ * Los temporales locales a un bloque (la gran mayoría) se resuelven con
+ * un solo recorrido; solo los que cruzan bloques pasan por el análisis
+ * de vida iterativo con conjuntos de bits.
+ */
+
+#define WORD_BITS (8 * sizeof(unsigned long))
+
+typedef struct {
+    int start;          // Primer punto vivo (medios pasos)
+    int end;            // Último punto vivo
+    int block;          // Bloque de la primera aparición
+    int global;         // 1 si vive entre bloques
+    int seen;
+} TempInfo;
+
+/* ============================================================
+   CONJUNTOS DE BITS
+   ============================================================ */
+
+static int testBit(unsigned long* set, int i) {
+    return (set[i / WORD_BITS] >> (i % WORD_BITS)) & 1UL;
+}
+
+static void setBit(unsigned long* set, int i) {
+    set[i / WORD_BITS] |= 1UL << (i % WORD_BITS);
+}
+
+/* ============================================================
+   INTERVALOS
+   ============================================================ */
+
+static void extend(TempInfo* t, int point) {
+    if (!t->seen) {
+        t->start = t->end = point;
+        t->seen = 1;
+        return;
+    }
+    if (point < t->start) t->start = point;
+    if (point > t->end) t->end = point;
+}
+
+// Primera pasada: puntos de uso/definición y detección de globales
+static void scanTemps(IRProgram* prog, TempInfo* info, int* lastDefBlock) {
+    for (int b = 0; b < prog->blockCount; b++) {
+        for (int i = prog->blocks[b].start; i < prog->blocks[b].end; i++) {
+            IRInstr* ins = &prog->code[i];
+            Operand* uses[3];
+            int n = irUses(ins, uses);
+
+            for (int k = 0; k < n; k++) {
+                if (uses[k]->kind != OPD_TEMP) continue;
+                TempInfo* t = &info[uses[k]->num];
+                // Leído sin definición previa en este bloque: vive entre bloques
+                if (lastDefBlock[uses[k]->num] != b) t->global = 1;
+                if (t->seen && t->block != b) t->global = 1;
+                if (!t->seen) t->block = b;
+                extend(t, 2 * i);
+            }
+
+            Operand* def = irDef(ins);
+            if (def && def->kind == OPD_TEMP) {
+                TempInfo* t = &info[def->num];
+                if (t->seen && t->block != b) t->global = 1;
+                if (!t->seen) t->block = b;
+                lastDefBlock[def->num] = b;
+                extend(t, 2 * i + 1);
+            }
+        }
+    }
+}
+
+// Análisis de vida iterativo para los temporales globales
+static void extendGlobals(IRProgram* prog, TempInfo* info, int tempLimit) {
+    int* globalIndex = malloc(sizeof(int) * (tempLimit + 1));
+    int globalCount = 0;
+    for (int t = 0; t < tempLimit; t++) {
+        globalIndex[t] = info[t].global ? globalCount++ : -1;
+    }
+    if (globalCount == 0) {
+        free(globalIndex);
+        return;
+    }
+
+    int words = (globalCount + WORD_BITS - 1) / WORD_BITS;
+    int blocks = prog->blockCount;
+    unsigned long* use = calloc((size_t)blocks * words, sizeof(unsigned long));
+    unsigned long* def = calloc((size_t)blocks * words, sizeof(unsigned long));
+    unsigned long* liveIn = calloc((size_t)blocks * words, sizeof(unsigned long));
+    unsigned long* liveOut = calloc((size_t)blocks * words, sizeof(unsigned long));
+
+    // Conjuntos use/def locales de cada bloque
+    for (int b = 0; b < blocks; b++) {
+        unsigned long* u = &use[(size_t)b * words];
+        unsigned long* d = &def[(size_t)b * words];
+        for (int i = prog->blocks[b].start; i < prog->blocks[b].end; i++) {
+            IRInstr* ins = &prog->code[i];
+            Operand* uses[3];
+            int n = irUses(ins, uses);
+            for (int k = 0; k < n; k++) {
+                if (uses[k]->kind != OPD_TEMP) continue;
+                int g = globalIndex[uses[k]->num];
+                if (g >= 0 && !testBit(d, g)) setBit(u, g);
+            }
+            Operand* dst = irDef(ins);
+            if (dst && dst->kind == OPD_TEMP) {
+                int g = globalIndex[dst->num];
+                if (g >= 0) setBit(d, g);
+            }
+        }
+    }
+
+    // Iterar hasta punto fijo: out = U in(succ), in = use | (out - def)
+    int limit;
+    int* labelBlock = irLabelBlockMap(prog, &limit);
+    int changed = 1;
+    while (changed) {
+        changed = 0;
+        for (int b = blocks - 1; b >= 0; b--) {
+            unsigned long* out = &liveOut[(size_t)b * words];
+            unsigned long* in = &liveIn[(size_t)b * words];
+            int succ[2];
+            int n = irBlockSuccessors(prog, b, labelBlock, succ);
+
+            for (int w = 0; w < words; w++) {
+                unsigned long o = 0;
+                for (int k = 0; k < n; k++) {
+                    if (succ[k] >= 0) o |= liveIn[(size_t)succ[k] * words + w];
+                }
+                unsigned long i = use[(size_t)b * words + w] |
+                                  (o & ~def[(size_t)b * words + w]);
+                if (o != out[w] || i != in[w]) {
+                    out[w] = o;
+                    in[w] = i;
+                    changed = 1;
+                }
+            }
+        }
+    }
+
+    // Extender los intervalos hasta los bordes de bloque donde están vivos
+    for (int t = 0; t < tempLimit; t++) {
+        int g = globalIndex[t];
+        if (g < 0) continue;
+        for (int b = 0; b < blocks; b++) {
+            if (testBit(&liveIn[(size_t)b * words], g)) {
+                extend(&info[t], 2 * prog->blocks[b].start);
+            }
+            if (testBit(&liveOut[(size_t)b * words], g)) {
+                extend(&info[t], 2 * (prog->blocks[b].end - 1) + 1);
+            }
+        }
+    }
+
+    free(labelBlock);
+    free(use);
+    free(def);
+    free(liveIn);
+    free(liveOut);
+    free(globalIndex);
+}
+
+/* ============================================================
+   ASIGNACIÓN LINEAL
+   ============================================================ */
+
+static TempInfo* sortInfo = NULL;
+
+static int compareStart(const void* x, const void* y) {
+    int a = *(const int*)x;
+    int b = *(const int*)y;
+    if (sortInfo[a].start != sortInfo[b].start) {
+        return sortInfo[a].start - sortInfo[b].start;
+    }
+    return a - b;
+}
+
+// Montículo mínimo de temporales activos ordenado por fin de intervalo
+static void heapPush(int* heap, int* size, int t, TempInfo* info) {
+    int i = (*size)++;
+    heap[i] = t;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (info[heap[parent]].end <= info[heap[i]].end) break;
+        int tmp = heap[parent];
+        heap[parent] = heap[i];
+        heap[i] = tmp;
+        i = parent;
+    }
+}
+
+static int heapPop(int* heap, int* size, TempInfo* info) {
+    int top = heap[0];
+    heap[0] = heap[--(*size)];
+    int i = 0;
+    while (1) {
+        int l = 2 * i + 1;
+        int r = l + 1;
+        int m = i;
+        if (l < *size && info[heap[l]].end < info[heap[m]].end) m = l;
+        if (r < *size && info[heap[r]].end < info[heap[m]].end) m = r;
+        if (m == i) break;
+        int tmp = heap[m];
+        heap[m] = heap[i];
+        heap[i] = tmp;
+        i = m;
+    }
+    return top;
+}
+
+TempAllocStats allocateTemps(IRProgram* prog) {
+    TempAllocStats stats = { 0, 0 };
+    int tempLimit = irMaxTemp(prog);
+    if (tempLimit == 0) return stats;
+
+    irBuildBlocks(prog);
+
+    TempInfo* info = calloc(tempLimit, sizeof(TempInfo));
+    int* lastDefBlock = malloc(sizeof(int) * tempLimit);
+    for (int t = 0; t < tempLimit; t++) lastDefBlock[t] = -1;
+
+    scanTemps(prog, info, lastDefBlock);
+    extendGlobals(prog, info, tempLimit);
+
+    // Ordenar por inicio y asignar celdas libres
+    int* order = malloc(sizeof(int) * tempLimit);
+    int used = 0;
+    for (int t = 0; t < tempLimit; t++) {
+        if (info[t].seen) order[used++] = t;
+    }
+    sortInfo = info;
+    qsort(order, used, sizeof(int), compareStart);
+
+    int* slot = malloc(sizeof(int) * tempLimit);
+    int* freeSlots = malloc(sizeof(int) * (used + 1));
+    int* active = malloc(sizeof(int) * (used + 1));
+    int freeCount = 0;
+    int activeCount = 0;
+    int slotCount = 0;
+
+    for (int k = 0; k < used; k++) {
+        int t = order[k];
+        while (activeCount > 0 && info[active[0]].end < info[t].start) {
+            freeSlots[freeCount++] = slot[heapPop(active, &activeCount, info)];
+        }
+        slot[t] = freeCount > 0 ? freeSlots[--freeCount] : slotCount++;
+        heapPush(active, &activeCount, t, info);
+    }
+
+    // Reescribir operandos y reemplazar las declaraciones de temporales
+    int declared = 0;
+    for (int i = 0; i < prog->count; i++) {
+        IRInstr* ins = &prog->code[i];
+        if (ins->op == IR_VAR && ins->dst.kind == OPD_TEMP) {
+            ins->op = IR_NOP;
+            declared++;
+            continue;
+        }
+        Operand* ops[4] = { &ins->dst, &ins->a, &ins->b, &ins->c };
+        for (int j = 0; j < 4; j++) {
+            if (ops[j]->kind == OPD_TEMP) ops[j]->num = slot[ops[j]->num];
+        }
+    }
+
+    // Las celdas de la reserva se declaran al inicio del programa
+    int capacity = prog->count + slotCount + 1;
+    IRInstr* code = malloc(sizeof(IRInstr) * capacity);
+    for (int s = 0; s < slotCount; s++) {
+        memset(&code[s], 0, sizeof(IRInstr));
+        code[s].op = IR_VAR;
+        code[s].dst = opTemp(s);
+        code[s].label = -1;
+    }
+    int n = slotCount;
+    for (int i = 0; i < prog->count; i++) {
+        if (prog->code[i].op != IR_NOP) code[n++] = prog->code[i];
+    }
+    free(prog->code);
+    prog->code = code;
+    prog->count = n;
+    prog->capacity = capacity;
+    irBuildBlocks(prog);
+
+    stats.tempsBefore = declared > used ? declared : used;
+    stats.slotsAfter = slotCount;
+
+    free(info);
+    free(lastDefBlock);
+    free(order);
+    free(slot);
+    free(freeSlots);
+    free(active);
+    return stats;
+}
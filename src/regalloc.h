@@ -0,0 +1,16 @@
+/* regalloc.h - Reutilización de temporales por análisis de vida */
+#ifndef REGALLOC_H
+#define REGALLOC_H
+
+#include "ir.h"
+
+// Resultado de la asignación de temporales
+typedef struct {
+    int tempsBefore;    // Temporales distintos generados
+    int slotsAfter;     // Celdas de datos realmente usadas
+} TempAllocStats;
+
+// Asigna los temporales Tn a un conjunto mínimo de celdas reutilizables
+TempAllocStats allocateTemps(IRProgram* prog);
+
+#endif
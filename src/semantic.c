@@ -8,6 +8,12 @@
 static int errorCount = 0;
 static int warningCount = 0;
 
+// Función cuyo cuerpo se está verificando (NULL en el nivel superior)
+static ASTNode *currentFunction = NULL;
+static int blockDepth = 0;
+
+int checkSemanticsRecursive(ASTNode *node);
+
 void semanticError(const char *format, ...)
 {
     va_list args;
@@ -58,15 +64,49 @@ int checkTypeCompatibility(VarType t1, VarType t2)
     return 0;
 }
 
-VarType inferType(ASTNode *node)
+static int isExpression(ASTNode *node)
 {
-    if (!node)
-        return TYPE_VOID_T;
+    switch (node->type)
+    {
+    case NODE_INT:
+    case NODE_FLOAT:
+    case NODE_BOOL:
+    case NODE_STRING:
+    case NODE_ID:
+    case NODE_ARRAY_ACCESS:
+    case NODE_ARRAY_LENGTH:
+    case NODE_CALL:
+    case NODE_ADD:
+    case NODE_SUB:
+    case NODE_MUL:
+    case NODE_DIV:
+    case NODE_MOD:
+    case NODE_LT:
+    case NODE_GT:
+    case NODE_LTE:
+    case NODE_GTE:
+    case NODE_EQ:
+    case NODE_NEQ:
+    case NODE_AND:
+    case NODE_OR:
+    case NODE_NOT:
+        return 1;
+
+    default:
+        return 0;
+    }
+}
 
+// Tipo de una expresión a partir de los tipos ya calculados de sus hijos.
+// checkSemanticsRecursive lo guarda en node->varType al terminar cada
+// expresión, así que cada subárbol se tipa una sola vez.
+static VarType computeType(ASTNode *node)
+{
     switch (node->type)
     {
     case NODE_INT:
     case NODE_BOOL:
+    case NODE_ARRAY_LENGTH:
         return TYPE_INT_T;
 
     case NODE_FLOAT:
@@ -77,26 +117,19 @@ VarType inferType(ASTNode *node)
 
     case NODE_ID:
     {
+        // Si no está declarada, validateVariableUsage ya lo reportó
         Symbol *sym = findSymbol(node->idName);
-        if (sym)
-        {
-            return sym->type;
-        }
-        else
-        {
-            semanticError("Variable '%s' no declarada", node->idName);
-            return TYPE_VOID_T;
-        }
+        return sym ? sym->type : TYPE_VOID_T;
     }
 
     case NODE_ARRAY_ACCESS:
     {
+        // Los errores del acceso se reportan en validateArrayAccess
         Symbol *sym = findSymbol(node->idName);
         if (sym && sym->kind == SYM_ARRAY)
         {
             return sym->type;
         }
-        semanticError("'%s' no es un arreglo", node->idName);
         return TYPE_VOID_T;
     }
 
@@ -106,8 +139,8 @@ VarType inferType(ASTNode *node)
     case NODE_DIV:
     case NODE_MOD:
     {
-        VarType leftType = inferType(node->left);
-        VarType rightType = inferType(node->right);
+        VarType leftType = inferType(AST_LEFT(node));
+        VarType rightType = inferType(AST_RIGHT(node));
 
         if (!isNumericType(leftType) || !isNumericType(rightType))
         {
@@ -131,6 +164,17 @@ VarType inferType(ASTNode *node)
     case NODE_NEQ:
         return TYPE_BOOL_T;
 
+    case NODE_CALL:
+    {
+        // Los errores de la llamada se reportan en validateFunctionCall
+        Symbol *sym = findSymbol(node->idName);
+        if (sym && sym->kind == SYM_FUNCTION)
+        {
+            return sym->returnType;
+        }
+        return TYPE_VOID_T;
+    }
+
     case NODE_AND:
     case NODE_OR:
     case NODE_NOT:
@@ -141,6 +185,15 @@ VarType inferType(ASTNode *node)
     }
 }
 
+// Tipo ya calculado de una expresión verificada (no recorre el subárbol)
+VarType inferType(ASTNode *node)
+{
+    if (!node)
+        return TYPE_VOID_T;
+    return node->varType;
+}
+
+// La expresión asignada ya debe estar verificada (usa su tipo calculado)
 int validateAssignment(ASTNode *node)
 {
     if (node->type != NODE_ASSIGN)
@@ -153,7 +206,7 @@ int validateAssignment(ASTNode *node)
         return 0;
     }
 
-    VarType exprType = inferType(node->left);
+    VarType exprType = inferType(AST_LEFT(node));
 
     if (!checkTypeCompatibility(sym->type, exprType))
     {
@@ -167,6 +220,7 @@ int validateAssignment(ASTNode *node)
     return 1;
 }
 
+// El índice ya debe estar verificado (usa su tipo calculado)
 int validateArrayAccess(ASTNode *node)
 {
     if (node->type != NODE_ARRAY_ACCESS)
@@ -185,7 +239,7 @@ int validateArrayAccess(ASTNode *node)
         return 0;
     }
 
-    VarType indexType = inferType(node->index);
+    VarType indexType = inferType(AST_INDEX(node));
     if (indexType != TYPE_INT_T)
     {
         semanticError("El índice del arreglo debe ser int, es %s",
@@ -194,9 +248,9 @@ int validateArrayAccess(ASTNode *node)
     }
 
     // Verificar rango si es constante
-    if (node->index->type == NODE_INT)
+    if (AST_INDEX(node)->type == NODE_INT)
     {
-        int idx = node->index->intValue;
+        int idx = AST_INDEX(node)->intValue;
         if (idx < 0 || idx >= sym->arraySize)
         {
             semanticError("Índice %d fuera de rango [0, %d]",
@@ -208,6 +262,64 @@ int validateArrayAccess(ASTNode *node)
     return 1;
 }
 
+int validateFunctionCall(ASTNode *node)
+{
+    if (node->type != NODE_CALL)
+        return 1;
+
+    Symbol *sym = findSymbol(node->idName);
+    if (!sym)
+    {
+        semanticError("Función '%s' no declarada", node->idName);
+        return 0;
+    }
+
+    if (sym->kind != SYM_FUNCTION)
+    {
+        semanticError("'%s' no es una función", node->idName);
+        return 0;
+    }
+
+    // Cada función tiene celdas fijas para sus parámetros: sin pila no
+    // puede haber dos activaciones a la vez
+    if (currentFunction && currentFunction->idName == node->idName)
+    {
+        semanticError("Recursión no soportada en '%s'", node->idName);
+        return 0;
+    }
+
+    int valid = 1;
+    int argCount = 0;
+    Symbol *param = sym->params;
+    for (ASTNode *arg = AST_ARGS(node); arg; arg = arg->next)
+    {
+        argCount++;
+        valid &= checkSemanticsRecursive(arg);
+        if (param)
+        {
+            VarType argType = inferType(arg);
+            if (!checkTypeCompatibility(param->type, argType))
+            {
+                semanticError("Argumento %d de '%s' debe ser %s, es %s",
+                              argCount, node->idName,
+                              varTypeToString(param->type),
+                              varTypeToString(argType));
+                valid = 0;
+            }
+            param = param->nextParam;
+        }
+    }
+
+    if (argCount != sym->paramCount)
+    {
+        semanticError("'%s' espera %d argumentos, recibe %d",
+                      node->idName, sym->paramCount, argCount);
+        return 0;
+    }
+
+    return valid;
+}
+
 int validateVariableUsage(ASTNode *node)
 {
     if (node->type != NODE_ID)
@@ -239,16 +351,91 @@ int checkSemanticsRecursive(ASTNode *node)
     switch (node->type)
     {
     case NODE_SEQ:
-        valid &= checkSemanticsRecursive(node->left);
-        valid &= checkSemanticsRecursive(node->right);
+        for (int i = 0; i < AST_STMT_COUNT(node); i++)
+        {
+            valid &= checkSemanticsRecursive(AST_STMT(node, i));
+        }
         break;
 
     case NODE_BLOCK:
         enterScope();
-        valid &= checkSemanticsRecursive(node->body);
+        blockDepth++;
+        valid &= checkSemanticsRecursive(AST_BODY(node));
+        blockDepth--;
         exitScope();
         break;
 
+    case NODE_FUNCTION:
+    {
+        if (currentFunction || blockDepth > 0)
+        {
+            semanticError("La función '%s' debe definirse en el nivel superior",
+                          node->idName);
+            valid = 0;
+            break;
+        }
+
+        Symbol *func = addSymbol(node->idName, node->varType, SYM_FUNCTION);
+        if (!func)
+        {
+            valid = 0;
+            break;
+        }
+        setFunctionReturn(func, node->varType);
+
+        // Los parámetros ya tienen nombres propios de la función (qualifyLocals)
+        for (ASTNode *p = AST_PARAMS(node); p; p = p->next)
+        {
+            Symbol *param = addSymbol(p->idName, p->varType, SYM_PARAMETER);
+            if (param)
+            {
+                param->isInitialized = 1;
+                addParameter(func, param);
+            }
+            else
+            {
+                valid = 0;
+            }
+        }
+
+        currentFunction = node;
+        valid &= checkSemanticsRecursive(AST_BODY(node));
+        currentFunction = NULL;
+        break;
+    }
+
+    case NODE_CALL:
+        valid &= validateFunctionCall(node);
+        break;
+
+    case NODE_RETURN:
+        valid &= checkSemanticsRecursive(AST_LEFT(node));
+        if (currentFunction)
+        {
+            VarType expected = currentFunction->varType;
+            if (expected == TYPE_VOID_T && AST_LEFT(node))
+            {
+                semanticError("La función '%s' no retorna valor",
+                              currentFunction->idName);
+                valid = 0;
+            }
+            else if (expected != TYPE_VOID_T && !AST_LEFT(node))
+            {
+                semanticError("La función '%s' debe retornar %s",
+                              currentFunction->idName, varTypeToString(expected));
+                valid = 0;
+            }
+            else if (AST_LEFT(node) && !checkTypeCompatibility(expected, inferType(AST_LEFT(node))))
+            {
+                semanticError("Retorno de tipo incompatible en '%s': %s := %s",
+                              currentFunction->idName,
+                              varTypeToString(expected),
+                              varTypeToString(inferType(AST_LEFT(node))));
+                valid = 0;
+            }
+        }
+        break;
+
     case NODE_ASSIGN:
     {
         // DEBUG: Ver qué tipo tiene el nodo
@@ -265,7 +452,8 @@ int checkSemanticsRecursive(ASTNode *node)
             {
                 sym->isInitialized = 1;
             }
-            VarType exprType = inferType(node->left);
+            valid &= checkSemanticsRecursive(AST_LEFT(node));
+            VarType exprType = inferType(AST_LEFT(node));
             if (!checkTypeCompatibility(node->varType, exprType))
             {
                 semanticError("Declaración con tipo incompatible: %s := %s",
@@ -278,9 +466,11 @@ int checkSemanticsRecursive(ASTNode *node)
         {
             fprintf(stderr, "DEBUG: Es asignación simple\n");
             // Es una asignación simple o a arreglo
-            if (node->index != NULL)
+            if (AST_INDEX(node) != NULL)
             {
                 // Asignación a arreglo: arr[i] = 10;
+                valid &= checkSemanticsRecursive(AST_INDEX(node));
+                valid &= checkSemanticsRecursive(AST_LEFT(node));
                 Symbol *sym = findSymbol(node->idName);
                 if (!sym)
                 {
@@ -295,29 +485,28 @@ int checkSemanticsRecursive(ASTNode *node)
                 else
                 {
                     // Validar tipo del índice
-                    VarType indexType = inferType(node->index);
+                    VarType indexType = inferType(AST_INDEX(node));
                     if (indexType != TYPE_INT_T && indexType != TYPE_VOID_T)
                     {
                         semanticError("El índice del arreglo debe ser int");
                         valid = 0;
                     }
                     // Validar tipo del valor
-                    VarType exprType = inferType(node->left);
+                    VarType exprType = inferType(AST_LEFT(node));
                     if (!checkTypeCompatibility(sym->type, exprType))
                     {
                         semanticError("Tipo incompatible en asignación a arreglo");
                         valid = 0;
                     }
                 }
-                valid &= checkSemanticsRecursive(node->index);
             }
             else
             {
                 // Asignación simple a variable: x = 10;
+                valid &= checkSemanticsRecursive(AST_LEFT(node));
                 valid &= validateAssignment(node);
             }
         }
-        valid &= checkSemanticsRecursive(node->left);
         break;
     }
 
@@ -332,24 +521,24 @@ int checkSemanticsRecursive(ASTNode *node)
     }
 
     case NODE_ARRAY_ACCESS:
+        valid &= checkSemanticsRecursive(AST_INDEX(node));
         valid &= validateArrayAccess(node);
-        valid &= checkSemanticsRecursive(node->index);
         break;
 
     case NODE_IF:
     case NODE_IF_ELSE:
     {
-        VarType condType = inferType(node->cond);
+        valid &= checkSemanticsRecursive(AST_COND(node));
+        VarType condType = inferType(AST_COND(node));
         if (!isBooleanType(condType) && condType != TYPE_INT_T)
         {
             semanticError("Condición de if debe ser booleana o int");
             valid = 0;
         }
-        valid &= checkSemanticsRecursive(node->cond);
-        valid &= checkSemanticsRecursive(node->body);
+        valid &= checkSemanticsRecursive(AST_BODY(node));
         if (node->type == NODE_IF_ELSE)
         {
-            valid &= checkSemanticsRecursive(node->elseBody);
+            valid &= checkSemanticsRecursive(AST_ELSE(node));
         }
         break;
     }
@@ -357,19 +546,19 @@ int checkSemanticsRecursive(ASTNode *node)
     case NODE_WHILE:
     case NODE_FOR:
     {
-        VarType condType = inferType(node->cond);
+        if (node->type == NODE_FOR)
+        {
+            valid &= checkSemanticsRecursive(AST_INIT(node));
+            valid &= checkSemanticsRecursive(AST_INCREMENT(node));
+        }
+        valid &= checkSemanticsRecursive(AST_COND(node));
+        VarType condType = inferType(AST_COND(node));
         if (!isBooleanType(condType) && condType != TYPE_INT_T)
         {
             semanticError("Condición de bucle debe ser booleana o int");
             valid = 0;
         }
-        if (node->type == NODE_FOR)
-        {
-            valid &= checkSemanticsRecursive(node->init);
-            valid &= checkSemanticsRecursive(node->increment);
-        }
-        valid &= checkSemanticsRecursive(node->cond);
-        valid &= checkSemanticsRecursive(node->body);
+        valid &= checkSemanticsRecursive(AST_BODY(node));
         break;
     }
 
@@ -390,25 +579,23 @@ int checkSemanticsRecursive(ASTNode *node)
     case NODE_NEQ:
     case NODE_AND:
     case NODE_OR:
-        valid &= checkSemanticsRecursive(node->left);
-        valid &= checkSemanticsRecursive(node->right);
-        // El tipo se verifica en inferType
-        (void)inferType(node);
+        valid &= checkSemanticsRecursive(AST_LEFT(node));
+        valid &= checkSemanticsRecursive(AST_RIGHT(node));
+        // El tipo se verifica en computeType, al final
         break;
 
     case NODE_NOT:
-        valid &= checkSemanticsRecursive(node->left);
+        valid &= checkSemanticsRecursive(AST_LEFT(node));
         break;
 
     case NODE_PIXEL:
-        valid &= checkSemanticsRecursive(node->left);
-        valid &= checkSemanticsRecursive(node->right);
-        valid &= checkSemanticsRecursive(node->extra);
+        valid &= checkSemanticsRecursive(AST_LEFT(node));
+        valid &= checkSemanticsRecursive(AST_RIGHT(node));
+        valid &= checkSemanticsRecursive(AST_EXTRA(node));
         break;
 
     case NODE_PRINT:
-    case NODE_RETURN:
-        valid &= checkSemanticsRecursive(node->left);
+        valid &= checkSemanticsRecursive(AST_LEFT(node));
         break;
 
     default:
@@ -416,6 +603,12 @@ int checkSemanticsRecursive(ASTNode *node)
         break;
     }
 
+    // Los hijos ya tienen su tipo: calcular el de esta expresión una vez
+    if (isExpression(node))
+    {
+        node->varType = computeType(node);
+    }
+
     return valid;
 }
 
@@ -423,6 +616,8 @@ int checkSemantics(ASTNode *root)
 {
     errorCount = 0;
     warningCount = 0;
+    currentFunction = NULL;
+    blockDepth = 0;
 
     int valid = checkSemanticsRecursive(root);
 
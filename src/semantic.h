@@ -14,7 +14,7 @@ typedef struct {
 
 // Funciones principales
 int checkSemantics(ASTNode* root);
-VarType inferType(ASTNode* node);
+VarType inferType(ASTNode* node);  // Tipo ya calculado por checkSemantics
 int checkTypeCompatibility(VarType t1, VarType t2);
 
 // Validaciones específicas
@@ -0,0 +1,132 @@
+/* stats.c - Estadísticas de compilación por fase (--stats, --stats-json) */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+#include "stats.h"
+
+/*
+ * Cada fase guarda su tiempo real (CLOCK_MONOTONIC), su tiempo de CPU
+ * (CLOCK_PROCESS_CPUTIME_ID) y el pico de memoria residente al terminar.
+ * El pico nunca baja: una fase que no reserva memoria repite el valor de
+ * la anterior, y la que lo sube es la que más memoria pidió.
+ */
+
+static PhaseStats phases[STATS_MAX_PHASES];
+static int phaseCount = 0;
+
+static struct timespec wallStart;
+static struct timespec cpuStart;
+
+static double elapsedMs(struct timespec* from, clockid_t clock) {
+    struct timespec now;
+    clock_gettime(clock, &now);
+    return (now.tv_sec - from->tv_sec) * 1e3 + (now.tv_nsec - from->tv_nsec) / 1e6;
+}
+
+void statsBegin(const char* phase) {
+    if (phaseCount == STATS_MAX_PHASES) return;
+    phases[phaseCount].name = phase;
+    clock_gettime(CLOCK_MONOTONIC, &wallStart);
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpuStart);
+}
+
+void statsEnd() {
+    if (phaseCount == STATS_MAX_PHASES) return;
+    PhaseStats* p = &phases[phaseCount++];
+    p->wallMs = elapsedMs(&wallStart, CLOCK_MONOTONIC);
+    p->cpuMs = elapsedMs(&cpuStart, CLOCK_PROCESS_CPUTIME_ID);
+    p->peakRssKB = statsPeakRSS();
+}
+
+long statsPeakRSS() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+    return usage.ru_maxrss;     // En Linux ya viene en KB
+}
+
+/* ============================================================
+   REPORTES
+   ============================================================ */
+
+// Escribe el nombre rellenado a 'width' columnas (los acentos ocupan dos bytes)
+static void printPadded(FILE* out, const char* name, int width) {
+    int columns = 0;
+    for (const char* p = name; *p; p++) {
+        if (((unsigned char)*p & 0xC0) != 0x80) columns++;
+    }
+    fprintf(out, "  %s%*s", name, columns < width ? width - columns : 0, "");
+}
+
+void statsPrint(FILE* out, const CompileCounters* c) {
+    double wall = 0, cpu = 0;
+
+    fprintf(out, "\n╔════════════════════════════════════════╗\n");
+    fprintf(out, "║   ESTADÍSTICAS DE COMPILACIÓN          ║\n");
+    fprintf(out, "╚════════════════════════════════════════╝\n");
+    fprintf(out, "  %-22s %10s %10s %10s\n", "Fase", "Real (ms)", "CPU (ms)", "RSS (KB)");
+    for (int i = 0; i < phaseCount; i++) {
+        printPadded(out, phases[i].name, 22);
+        fprintf(out, " %10.3f %10.3f %10ld\n",
+                phases[i].wallMs, phases[i].cpuMs, phases[i].peakRssKB);
+        wall += phases[i].wallMs;
+        cpu += phases[i].cpuMs;
+    }
+    fprintf(out, "  %-22s %10.3f %10.3f %10ld\n", "total", wall, cpu, statsPeakRSS());
+    fprintf(out, "\n");
+    fprintf(out, "  Líneas:         %d\n", c->lines);
+    fprintf(out, "  Nodos del AST:  %d (%zu bytes de arena)\n", c->nodes, c->astBytes);
+    fprintf(out, "  Profundidad:    %d\n", c->depth);
+    fprintf(out, "  Símbolos:       %d\n", c->symbols);
+    fprintf(out, "  Temporales:     %d (%d celdas)\n", c->temps, c->tempSlots);
+    fprintf(out, "  Etiquetas:      %d\n", c->labels);
+    fprintf(out, "  Instrucciones:  %d\n", c->instructions);
+    fprintf(out, "\n");
+}
+
+// Escribe una cadena JSON escapando comillas, barras y controles
+static void printJSONString(FILE* out, const char* s) {
+    fputc('"', out);
+    for (; *s; s++) {
+        unsigned char ch = (unsigned char)*s;
+        if (ch == '"' || ch == '\\') {
+            fprintf(out, "\\%c", ch);
+        } else if (ch < 0x20) {
+            fprintf(out, "\\u%04x", ch);
+        } else {
+            fputc(ch, out);
+        }
+    }
+    fputc('"', out);
+}
+
+void statsPrintJSON(FILE* out, const char* inputFile, const CompileCounters* c) {
+    double wall = 0, cpu = 0;
+
+    fprintf(out, "{\n  \"input\": ");
+    printJSONString(out, inputFile);
+    fprintf(out, ",\n  \"phases\": [\n");
+    for (int i = 0; i < phaseCount; i++) {
+        fprintf(out, "    {\"name\": ");
+        printJSONString(out, phases[i].name);
+        fprintf(out, ", \"wall_ms\": %.3f, \"cpu_ms\": %.3f, \"peak_rss_kb\": %ld}%s\n",
+                phases[i].wallMs, phases[i].cpuMs, phases[i].peakRssKB,
+                i + 1 < phaseCount ? "," : "");
+        wall += phases[i].wallMs;
+        cpu += phases[i].cpuMs;
+    }
+    fprintf(out, "  ],\n");
+    fprintf(out, "  \"total\": {\"wall_ms\": %.3f, \"cpu_ms\": %.3f, \"peak_rss_kb\": %ld},\n",
+            wall, cpu, statsPeakRSS());
+    fprintf(out, "  \"lines\": %d,\n", c->lines);
+    fprintf(out, "  \"ast_nodes\": %d,\n", c->nodes);
+    fprintf(out, "  \"ast_depth\": %d,\n", c->depth);
+    fprintf(out, "  \"ast_bytes\": %zu,\n", c->astBytes);
+    fprintf(out, "  \"symbols\": %d,\n", c->symbols);
+    fprintf(out, "  \"temps\": %d,\n", c->temps);
+    fprintf(out, "  \"temp_slots\": %d,\n", c->tempSlots);
+    fprintf(out, "  \"labels\": %d,\n", c->labels);
+    fprintf(out, "  \"instructions\": %d\n", c->instructions);
+    fprintf(out, "}\n");
+}
@@ -0,0 +1,42 @@
+/* stats.h - Estadísticas de compilación por fase (--stats, --stats-json) */
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+#define STATS_MAX_PHASES 32
+
+// Medición de una fase
+typedef struct {
+    const char* name;
+    double wallMs;      // Tiempo real
+    double cpuMs;       // Tiempo de CPU del proceso
+    long peakRssKB;     // Pico de memoria residente al terminar la fase
+} PhaseStats;
+
+// Tamaños del programa compilado
+typedef struct {
+    int lines;          // Líneas del fuente
+    int nodes;          // Nodos del AST recién construido
+    int depth;          // Profundidad del AST
+    size_t astBytes;    // Memoria de la arena del AST
+    int symbols;        // Símbolos en la tabla al terminar el análisis
+    int temps;          // Temporales generados
+    int tempSlots;      // Celdas tras reutilizar temporales
+    int labels;         // Etiquetas generadas
+    int instructions;   // Instrucciones emitidas
+} CompileCounters;
+
+// Abre y cierra una fase; las fases no se anidan
+void statsBegin(const char* phase);
+void statsEnd();
+
+// Pico de memoria residente del proceso hasta ahora (KB)
+long statsPeakRSS();
+
+// Reporte legible o JSON de las fases medidas y los contadores
+void statsPrint(FILE* out, const CompileCounters* counters);
+void statsPrintJSON(FILE* out, const char* inputFile, const CompileCounters* counters);
+
+#endif
@@ -4,65 +4,107 @@
 #include <string.h>
 #include "symtable.h"
 
-// Tabla hash simple (lista enlazada)
-#define TABLE_SIZE 256
-
-static Symbol* symbolTable[TABLE_SIZE];
+// Tabla hash con encadenamiento. Los nombres vienen internados (intern,
+// ast.h): el número del identificador es el hash y dos nombres son iguales
+// si son el mismo puntero. La tabla se duplica al superar 3/4 de ocupación.
+//
+// Cada scope lleva su propia lista de deshacer (enlazada por scopeNext)
+// con los símbolos que declaró: exitScope recorre solo esa lista.
+#define TABLE_INITIAL_SIZE 256
+#define SCOPES_INITIAL_SIZE 16
+
+static Symbol** symbolTable = NULL;
+static int tableSize = 0;
+static Symbol** scopeSymbols = NULL;    // Lista de deshacer de cada nivel
+static int scopeCapacity = 0;
 static int currentScope = 0;
 static int symbolCount = 0;
 
-// Función hash simple
-static unsigned int hash(const char* str) {
-    unsigned int hash = 5381;
-    int c;
-    while ((c = *str++))
-        hash = ((hash << 5) + hash) + c;
-    return hash % TABLE_SIZE;
+static unsigned int hash(const char* name) {
+    return (unsigned int)internId(name) & (tableSize - 1);
 }
 
-void initSymbolTable() {
-    for (int i = 0; i < TABLE_SIZE; i++) {
-        symbolTable[i] = NULL;
+// Duplica la tabla. Cada cadena conserva su orden relativo, así que un
+// nombre redeclarado en un scope interno sigue apareciendo primero.
+static void growTable() {
+    int oldSize = tableSize;
+    Symbol** old = symbolTable;
+    tableSize *= 2;
+    symbolTable = calloc(tableSize, sizeof(Symbol*));
+    Symbol** tails = calloc(tableSize, sizeof(Symbol*));
+    if (!symbolTable || !tails) {
+        fprintf(stderr, "Error: No se pudo ampliar la tabla de símbolos\n");
+        exit(1);
+    }
+    
+    for (int i = 0; i < oldSize; i++) {
+        Symbol* sym = old[i];
+        while (sym) {
+            Symbol* next = sym->next;
+            unsigned int index = hash(sym->name);
+            sym->next = NULL;
+            if (tails[index]) {
+                tails[index]->next = sym;
+            } else {
+                symbolTable[index] = sym;
+            }
+            tails[index] = sym;
+            sym = next;
+        }
     }
+    free(tails);
+    free(old);
+}
+
+static void freeSymbols() {
+    for (int level = currentScope; level >= 0 && scopeSymbols; level--) {
+        Symbol* sym = scopeSymbols[level];
+        while (sym) {
+            Symbol* next = sym->scopeNext;
+            free(sym);
+            sym = next;
+        }
+    }
+    free(symbolTable);
+    free(scopeSymbols);
+}
+
+void initSymbolTable() {
+    freeSymbols();
+    tableSize = TABLE_INITIAL_SIZE;
+    symbolTable = calloc(tableSize, sizeof(Symbol*));
+    scopeCapacity = SCOPES_INITIAL_SIZE;
+    scopeSymbols = calloc(scopeCapacity, sizeof(Symbol*));
     currentScope = 0;
     symbolCount = 0;
 }
 
 void enterScope() {
     currentScope++;
+    if (currentScope == scopeCapacity) {
+        scopeCapacity *= 2;
+        scopeSymbols = realloc(scopeSymbols, sizeof(Symbol*) * scopeCapacity);
+    }
+    scopeSymbols[currentScope] = NULL;
 }
 
 void exitScope() {
-    // Eliminar símbolos del scope actual
-    for (int i = 0; i < TABLE_SIZE; i++) {
-        Symbol* sym = symbolTable[i];
-        Symbol* prev = NULL;
-        
-        while (sym) {
-            if (sym->scopeLevel == currentScope) {
-                Symbol* toDelete = sym;
-                if (prev) {
-                    prev->next = sym->next;
-                    sym = sym->next;
-                } else {
-                    symbolTable[i] = sym->next;
-                    sym = symbolTable[i];
-                }
-                free(toDelete->name);
-                free(toDelete);
-                symbolCount--;
-            } else {
-                prev = sym;
-                sym = sym->next;
-            }
-        }
+    // Eliminar solo los símbolos declarados en el scope actual
+    Symbol* sym = scopeSymbols[currentScope];
+    while (sym) {
+        Symbol* next = sym->scopeNext;
+        Symbol** link = &symbolTable[hash(sym->name)];
+        while (*link != sym) link = &(*link)->next;
+        *link = sym->next;
+        free(sym);
+        symbolCount--;
+        sym = next;
     }
+    scopeSymbols[currentScope] = NULL;
     currentScope--;
 }
 
 Symbol* addSymbol(char* name, VarType type, SymbolKind kind) {
-    unsigned int index = hash(name);
-    
     // Verificar si ya existe en el scope actual
     Symbol* existing = findSymbolInCurrentScope(name);
     if (existing) {
@@ -72,7 +114,7 @@ Symbol* addSymbol(char* name, VarType type, SymbolKind kind) {
     
     // Crear nuevo símbolo
     Symbol* sym = malloc(sizeof(Symbol));
-    sym->name = strdup(name);
+    sym->name = name;
     sym->type = type;
     sym->kind = kind;
     sym->isInitialized = 0;
@@ -80,11 +122,19 @@ Symbol* addSymbol(char* name, VarType type, SymbolKind kind) {
     sym->returnType = TYPE_VOID_T;
     sym->paramCount = 0;
     sym->params = NULL;
+    sym->nextParam = NULL;
     sym->scopeLevel = currentScope;
     
-    // Insertar al inicio de la lista
+    if ((symbolCount + 1) * 4 > tableSize * 3) {
+        growTable();
+    }
+    
+    // Insertar al inicio de la cadena y de la lista del scope
+    unsigned int index = hash(name);
     sym->next = symbolTable[index];
     symbolTable[index] = sym;
+    sym->scopeNext = scopeSymbols[currentScope];
+    scopeSymbols[currentScope] = sym;
     
     symbolCount++;
     return sym;
@@ -96,7 +146,7 @@ Symbol* findSymbol(char* name) {
     
     // Buscar en todos los scopes (del actual hacia arriba)
     while (sym) {
-        if (strcmp(sym->name, name) == 0) {
+        if (sym->name == name) {
             return sym;
         }
         sym = sym->next;
@@ -109,7 +159,7 @@ Symbol* findSymbolInCurrentScope(char* name) {
     Symbol* sym = symbolTable[index];
     
     while (sym) {
-        if (strcmp(sym->name, name) == 0 && sym->scopeLevel == currentScope) {
+        if (sym->name == name && sym->scopeLevel == currentScope) {
             return sym;
         }
         sym = sym->next;
@@ -129,10 +179,13 @@ void setFunctionReturn(Symbol* sym, VarType retType) {
     }
 }
 
+// Agrega el parámetro al final: la lista queda en orden de declaración.
+// Usa nextParam para no romper la cadena de la tabla hash (next).
 void addParameter(Symbol* func, Symbol* param) {
-    if (func) {
-        param->next = func->params;
-        func->params = param;
+    if (func && param) {
+        Symbol** last = &func->params;
+        while (*last) last = &(*last)->nextParam;
+        *last = param;
         func->paramCount++;
     }
 }
@@ -146,7 +199,7 @@ void printSymbolTable() {
     printf("│ Nombre         │ Tipo     │ Clase    │ Scope │ Info   │\n");
     printf("├────────────────┼──────────┼──────────┼───────┼────────┤\n");
     
-    for (int i = 0; i < TABLE_SIZE; i++) {
+    for (int i = 0; i < tableSize; i++) {
         Symbol* sym = symbolTable[i];
         while (sym) {
             printf("│ %-14s │ %-8s │ %-8s │ %5d │ ", 
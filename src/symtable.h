@@ -14,7 +14,7 @@ typedef enum {
 
 // Entrada en la tabla de símbolos
 typedef struct Symbol {
-    char* name;
+    char* name;             // Internado: se compara por puntero
     VarType type;
     SymbolKind kind;
     
@@ -28,12 +28,14 @@ typedef struct Symbol {
     VarType returnType;
     int paramCount;
     struct Symbol* params;  // Lista de parámetros
+    struct Symbol* nextParam;  // Siguiente parámetro de la misma función
     
     // Scope
     int scopeLevel;
     
-    // Lista enlazada
+    // Cadena de la tabla hash y lista del scope que lo declaró
     struct Symbol* next;
+    struct Symbol* scopeNext;
 } Symbol;
 
 // Funciones públicas
@@ -41,6 +43,7 @@ void initSymbolTable();
 void enterScope();
 void exitScope();
 
+// Los nombres deben venir de intern() (los idName del AST ya lo son)
 Symbol* addSymbol(char* name, VarType type, SymbolKind kind);
 Symbol* findSymbol(char* name);
 Symbol* findSymbolInCurrentScope(char* name);
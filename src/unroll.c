@@ -0,0 +1,384 @@
+/* unroll.c - Desenrollado de bucles con número de vueltas conocido */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "unroll.h"
+
+/*
+ * Un bucle se desenrolla cuando su número de vueltas se puede calcular
+ * en tiempo de compilación:
+ *
+ *     i = <literal>;                 (sentencia anterior, o init del for)
+ *     while (i <op> <literal>) {
+ *         ...                        (no escribe i)
+ *         i = i + <literal>;         (última sentencia del cuerpo)
+ *     }
+ *
+ * con i declarada int. Si las copias caben en el presupuesto (en nodos
+ * del AST) el bucle se reemplaza por el cuerpo repetido con i sustituida
+ * por su valor en cada vuelta; así arr[i] pasa a ser un índice constante
+ * después del plegado. El incremento de un for es una expresión que las
+ * copias no repiten, así que no puede tener llamadas (writesVar las
+ * cuenta como escrituras de i). Si no cabe, se desenrolla parcialmente por un
+ * factor que divida el número de vueltas: las copias usan i + k*paso y un
+ * único incremento al final.
+ *
+ * Los bucles se procesan de adentro hacia afuera.
+ */
+
+#define MAX_TRIP_COUNT 100000
+
+static int budget;
+static UnrollStats stats;
+
+/* ============================================================
+   TIPOS DECLARADOS
+   ============================================================ */
+
+// Nombre -> tipo declarado; TYPE_VOID_T si se declaró con tipos distintos
+typedef struct {
+    const char* name;
+    VarType type;
+} DeclInfo;
+
+static DeclInfo* decls = NULL;
+static int declCapacity = 0;
+static int declCount = 0;
+
+// Los nombres están internados (intern): su número sirve de hash
+static unsigned int hashName(const char* name) {
+    return (unsigned int)internId(name);
+}
+
+static DeclInfo* lookupDecl(const char* name, int create);
+
+static void growDecls() {
+    DeclInfo* old = decls;
+    int oldCapacity = declCapacity;
+
+    declCapacity = declCapacity ? declCapacity * 2 : 256;
+    decls = calloc(declCapacity, sizeof(DeclInfo));
+    declCount = 0;
+    for (int i = 0; i < oldCapacity; i++) {
+        if (old[i].name) *lookupDecl(old[i].name, 1) = old[i];
+    }
+    free(old);
+}
+
+static DeclInfo* lookupDecl(const char* name, int create) {
+    if (create && (declCount + 1) * 4 > declCapacity * 3) growDecls();
+    if (declCapacity == 0) return NULL;
+
+    unsigned int i = hashName(name) & (declCapacity - 1);
+    while (decls[i].name) {
+        if (decls[i].name == name) return &decls[i];
+        i = (i + 1) & (declCapacity - 1);
+    }
+    if (!create) return NULL;
+
+    decls[i].name = name;
+    declCount++;
+    return &decls[i];
+}
+
+static void recordDecl(const char* name, VarType type) {
+    DeclInfo* existing = lookupDecl(name, 0);
+    if (existing) {
+        if (existing->type != type) existing->type = TYPE_VOID_T;
+        return;
+    }
+    lookupDecl(name, 1)->type = type;
+}
+
+static void collectDecls(ASTNode* node) {
+    if (!node) return;
+
+    if (node->type == NODE_ASSIGN && node->varType != TYPE_VOID_T && !AST_INDEX(node)) {
+        recordDecl(node->idName, node->varType);
+    } else if (node->type == NODE_ARRAY_DECL) {
+        recordDecl(node->idName, TYPE_VOID_T);
+    }
+
+    for (int k = 0; k < AST_KID_COUNT(node); k++) collectDecls(AST_KIDS(node)[k]);
+    collectDecls(node->next);
+}
+
+static int isIntVariable(const char* name) {
+    DeclInfo* d = lookupDecl(name, 0);
+    return d && d->type == TYPE_INT_T;
+}
+
+/* ============================================================
+   ANÁLISIS DEL BUCLE
+   ============================================================ */
+
+static int isId(ASTNode* node, const char* name) {
+    return node && node->type == NODE_ID && node->idName == name;
+}
+
+// 1 si el subárbol escribe la variable
+static int writesVar(ASTNode* node, const char* name) {
+    if (!node) return 0;
+    switch (node->type) {
+        case NODE_ASSIGN:
+            if (!AST_INDEX(node) && node->idName == name) return 1;
+            break;
+        case NODE_KEY:
+        case NODE_INPUT:
+            if (node->idName == name) return 1;
+            break;
+        case NODE_CALL:
+            // La función puede escribir cualquier variable global
+            return 1;
+        default:
+            break;
+    }
+    for (int k = 0; k < AST_KID_COUNT(node); k++) {
+        if (writesVar(AST_KIDS(node)[k], name)) return 1;
+    }
+    return writesVar(node->next, name);
+}
+
+// Paso de la forma i = i + c, i = c + i o i = i - c; 0 si no coincide
+static int incrementStep(ASTNode* stmt, const char* name) {
+    if (!stmt || stmt->type != NODE_ASSIGN || AST_INDEX(stmt)) return 0;
+    if (stmt->idName != name) return 0;
+    ASTNode* e = AST_LEFT(stmt);
+    if (!e) return 0;
+    if (e->type == NODE_ADD && isId(AST_LEFT(e), name) && AST_RIGHT(e)->type == NODE_INT) {
+        return AST_RIGHT(e)->intValue;
+    }
+    if (e->type == NODE_ADD && isId(AST_RIGHT(e), name) && AST_LEFT(e)->type == NODE_INT) {
+        return AST_LEFT(e)->intValue;
+    }
+    if (e->type == NODE_SUB && isId(AST_LEFT(e), name) && AST_RIGHT(e)->type == NODE_INT) {
+        return -AST_RIGHT(e)->intValue;
+    }
+    return 0;
+}
+
+static int compare(NodeType op, int a, int b) {
+    switch (op) {
+        case NODE_LT:  return a < b;
+        case NODE_GT:  return a > b;
+        case NODE_LTE: return a <= b;
+        case NODE_GTE: return a >= b;
+        case NODE_NEQ: return a != b;
+        default:       return 0;
+    }
+}
+
+static NodeType mirror(NodeType op) {
+    switch (op) {
+        case NODE_LT:  return NODE_GT;
+        case NODE_GT:  return NODE_LT;
+        case NODE_LTE: return NODE_GTE;
+        case NODE_GTE: return NODE_LTE;
+        default:       return op;
+    }
+}
+
+// Vueltas que da el bucle; -1 si no se puede calcular o son demasiadas
+static int tripCount(ASTNode* cond, const char* name, int start, int step) {
+    if (!cond) return -1;
+    NodeType op = cond->type;
+    if (op != NODE_LT && op != NODE_GT && op != NODE_LTE &&
+        op != NODE_GTE && op != NODE_NEQ) return -1;
+
+    int bound;
+    if (isId(AST_LEFT(cond), name) && AST_RIGHT(cond)->type == NODE_INT) {
+        bound = AST_RIGHT(cond)->intValue;
+    } else if (isId(AST_RIGHT(cond), name) && AST_LEFT(cond)->type == NODE_INT) {
+        bound = AST_LEFT(cond)->intValue;
+        op = mirror(op);
+    } else {
+        return -1;
+    }
+
+    int count = 0;
+    long long value = start;
+    while (compare(op, (int)value, bound)) {
+        if (++count > MAX_TRIP_COUNT) return -1;
+        value += step;
+    }
+    return count;
+}
+
+/* ============================================================
+   REESCRITURA
+   ============================================================ */
+
+static ASTNode* appendStmt(ASTNode* list, ASTNode* stmt) {
+    if (!stmt) return list;
+    if (!list) return stmt;
+    return newSeq(list, stmt);
+}
+
+// Reemplaza cada lectura de la variable por una copia de value
+static void substitute(ASTNode* node, const char* name, ASTNode* value) {
+    if (!node) return;
+    if (isId(node, name)) {
+        // Se conserva next: el ID puede ser un argumento de una llamada
+        ASTNode* copy = cloneAST(value);
+        ASTNode* next = node->next;
+        *node = *copy;
+        node->next = next;
+        freeNode(copy);
+        substitute(next, name, value);
+        return;
+    }
+    for (int k = 0; k < AST_KID_COUNT(node); k++) {
+        substitute(AST_KIDS(node)[k], name, value);
+    }
+    substitute(node->next, name, value);
+}
+
+// Copia del cuerpo con la variable reemplazada por value
+static ASTNode* instantiate(ASTNode* body, const char* name, ASTNode* value) {
+    ASTNode* copy = cloneAST(body);
+    substitute(copy, name, value);
+    return copy;
+}
+
+// Convierte el nodo del bucle en la secuencia dada
+static void replaceLoop(ASTNode* loop, ASTNode* seq) {
+    for (int k = 0; k < AST_MAX_KIDS; k++) freeAST(loop->kid[k]);
+    *loop = *seq;
+    freeNode(seq);
+}
+
+static void unrollLoop(ASTNode* loop, ASTNode* previous) {
+    ASTNode* init = (loop->type == NODE_FOR) ? AST_INIT(loop) : previous;
+    if (!init || init->type != NODE_ASSIGN || AST_INDEX(init)) return;
+    if (!AST_LEFT(init) || AST_LEFT(init)->type != NODE_INT) return;
+
+    const char* name = init->idName;
+    if (!isIntVariable(name)) return;
+    if (!AST_BODY(loop) || AST_BODY(loop)->type != NODE_BLOCK || !AST_BODY(AST_BODY(loop))) return;
+
+    // Cuerpo = rest; última sentencia = incremento. Mientras se analiza,
+    // el incremento sale de la secuencia y lo que queda es rest.
+    ASTNode* stmts = AST_BODY(AST_BODY(loop));
+    ASTNode* last = stmts;
+    ASTNode* rest = NULL;
+    if (stmts->type == NODE_SEQ) {
+        last = AST_STMT(stmts, AST_STMT_COUNT(stmts) - 1);
+        rest = stmts;
+        AST_STMT_COUNT(stmts)--;
+    }
+
+    int step = incrementStep(last, name);
+    int start = AST_LEFT(init)->intValue;
+    int trips = -1;
+    if (step != 0 && !writesVar(rest, name) &&
+        (loop->type != NODE_FOR || !writesVar(AST_INCREMENT(loop), name))) {
+        trips = tripCount(AST_COND(loop), name, start, step);
+    }
+
+    // Nodos por vuelta, sin contar la secuencia
+    int size = rest ? countNodes(rest) - 1 : 0;
+    if (size == 0) size = 1;
+
+    if (trips >= 0 && (long long)trips * size <= budget) {
+        // Desenrollado completo
+        ASTNode* seq = NULL;
+        if (loop->type == NODE_FOR) {
+            seq = AST_INIT(loop);
+            AST_INIT(loop) = NULL;
+        }
+        for (int k = 0; k < trips && rest; k++) {
+            ASTNode* value = newInt(start + k * step);
+            seq = appendStmt(seq, instantiate(rest, name, value));
+            freeAST(value);
+        }
+        // Valor final de la variable, por si se usa después
+        seq = appendStmt(seq, newAssign((char*)name, newInt(start + trips * step)));
+
+        if (rest) AST_STMT_COUNT(stmts)++;
+        replaceLoop(loop, seq);
+        stats.full++;
+        return;
+    }
+
+    // Desenrollado parcial por un factor que divida las vueltas
+    static const int factors[] = { 8, 4, 2 };
+    for (int f = 0; f < 3 && trips >= 0; f++) {
+        int factor = factors[f];
+        if (trips % factor != 0 || factor * size > budget || !rest) continue;
+
+        ASTNode* seq = cloneAST(rest);
+        for (int k = 1; k < factor; k++) {
+            ASTNode* value = newBinOp(NODE_ADD, newId((char*)name), newInt(k * step));
+            seq = appendStmt(seq, instantiate(rest, name, value));
+            freeAST(value);
+        }
+
+        // Un solo incremento de factor * paso
+        ASTNode* e = AST_LEFT(last);
+        ASTNode* literal = e->type == NODE_ADD && AST_LEFT(e)->type == NODE_INT
+                           ? AST_LEFT(e) : AST_RIGHT(e);
+        literal->intValue *= factor;
+        AST_BODY(AST_BODY(loop)) = newSeq(seq, last);
+        freeAST(rest);
+        stats.partial++;
+        return;
+    }
+
+    // El bucle queda como estaba
+    if (rest) AST_STMT_COUNT(stmts)++;
+}
+
+// Recorre las sentencias; cada bucle ve a la sentencia que lo precede
+static void unrollStatements(ASTNode* node, ASTNode* previous) {
+    if (!node) return;
+
+    switch (node->type) {
+        case NODE_SEQ:
+            for (int i = 0; i < AST_STMT_COUNT(node); i++) {
+                ASTNode* stmt = AST_STMT(node, i);
+                unrollStatements(stmt, previous);
+                // Un bucle desenrollado es ahora una secuencia
+                previous = stmt;
+                while (previous->type == NODE_SEQ) {
+                    previous = AST_STMT(previous, AST_STMT_COUNT(previous) - 1);
+                }
+            }
+            break;
+
+        case NODE_BLOCK:
+        case NODE_FUNCTION:
+            unrollStatements(AST_BODY(node), NULL);
+            break;
+
+        case NODE_IF:
+        case NODE_IF_ELSE:
+            unrollStatements(AST_BODY(node), NULL);
+            unrollStatements(AST_ELSE(node), NULL);
+            break;
+
+        case NODE_WHILE:
+        case NODE_FOR:
+            unrollStatements(AST_BODY(node), NULL);
+            unrollLoop(node, previous);
+            break;
+
+        default:
+            break;
+    }
+}
+
+UnrollStats unrollLoops(ASTNode* root, int maxNodes) {
+    stats.full = 0;
+    stats.partial = 0;
+    budget = maxNodes;
+    if (budget <= 0) return stats;
+
+    collectDecls(root);
+    unrollStatements(root, NULL);
+
+    free(decls);
+    decls = NULL;
+    declCapacity = 0;
+    declCount = 0;
+    return stats;
+}
@@ -0,0 +1,19 @@
+/* unroll.h - Desenrollado de bucles con número de vueltas conocido */
+#ifndef UNROLL_H
+#define UNROLL_H
+
+#include "ast.h"
+
+// Presupuesto por defecto: nodos del AST que puede ocupar un bucle desenrollado
+#define UNROLL_DEFAULT_BUDGET 200
+
+// Resultado del desenrollado
+typedef struct {
+    int full;           // Bucles reemplazados por todas sus vueltas
+    int partial;        // Bucles con el cuerpo repetido por un factor
+} UnrollStats;
+
+// Desenrolla los bucles cuyo número de vueltas se conoce; budget <= 0 desactiva
+UnrollStats unrollLoops(ASTNode* root, int budget);
+
+#endif